@@ -1135,6 +1135,11 @@ Drawable::Drawable(ThingTemplate const *thing_template, DrawableStatus status) :
     m_selected(false),
     m_ambientSoundEnabled(true),
     m_ambientSoundFromScriptEnabled(true)
+#ifndef GAME_DLL
+    ,
+    m_gridBucket(-1),
+    m_gridSlot(0)
+#endif
 {
     g_theGameClient->Register_Drawable(this);
     m_constructDisplayString = g_theDisplayStringManager->New_Display_String();
@@ -1852,6 +1857,10 @@ void Drawable::React_To_Transform_Change(const Matrix3D *matrix, const Coord3D *
     for (DrawModule **i = Get_Draw_Modules(); *i != nullptr; i++) {
         (*i)->React_To_Transform_Change(matrix, pos, angle);
     }
+
+#ifndef GAME_DLL
+    g_theGameClient->Get_Drawable_Grid().Update(this);
+#endif
 }
 
 void Drawable::Update_Hidden_Status()
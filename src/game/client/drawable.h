@@ -519,6 +519,12 @@ private:
     bool m_ambientSoundFromScriptEnabled;
     bool m_receivesDynamicLights;
     mutable bool m_isModelDirty;
+#ifndef GAME_DLL
+    int m_gridBucket;
+    int m_gridSlot;
+
+    friend class DrawableGridClass;
+#endif
 
     static bool s_staticImagesInited;
     static Image *s_veterancyImage[4];
@@ -0,0 +1,222 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Buckets drawables by their world position so screen regions only have to look at the ones nearby.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include "drawablegrid.h"
+#include "drawable.h"
+#include <algorithm>
+#include <cmath>
+
+enum
+{
+    GRID_BUCKET_COUNT = 4096, // Must be a power of two.
+};
+
+static const float GRID_CELL_SIZE = 80.0f;
+
+namespace
+{
+struct SequenceGreater
+{
+    template<typename T> bool operator()(const T &a, const T &b) const { return a.m_sequence > b.m_sequence; }
+};
+
+int Get_Cell(float coord)
+{
+    return int(floorf(coord / GRID_CELL_SIZE));
+}
+
+int Hash_Cell(int x, int y)
+{
+    return int((uint32_t(x) * 73856093u) ^ (uint32_t(y) * 19349663u)) & (GRID_BUCKET_COUNT - 1);
+}
+} // namespace
+
+DrawableGridClass::DrawableGridClass() :
+    m_buckets(GRID_BUCKET_COUNT), m_bucketStamps(GRID_BUCKET_COUNT, 0), m_stamp(0), m_nextSequence(0), m_count(0)
+{
+    Reset();
+}
+
+void DrawableGridClass::Reset()
+{
+    for (auto &bucket : m_buckets) {
+        for (EntryStruct &entry : bucket) {
+            entry.m_drawable->m_gridBucket = -1;
+        }
+
+        bucket.clear();
+    }
+
+    m_count = 0;
+    m_minZ = 1.0f;
+    m_maxZ = -1.0f;
+}
+
+int DrawableGridClass::Get_Bucket(float x, float y) const
+{
+    return Hash_Cell(Get_Cell(x), Get_Cell(y));
+}
+
+void DrawableGridClass::Insert(Drawable *draw, uint32_t sequence)
+{
+    const Coord3D *pos = draw->Get_Position();
+    int bucket = Get_Bucket(pos->x, pos->y);
+    EntryStruct entry;
+    entry.m_drawable = draw;
+    entry.m_sequence = sequence;
+    entry.m_x = pos->x;
+    entry.m_y = pos->y;
+    draw->m_gridBucket = bucket;
+    draw->m_gridSlot = int(m_buckets[bucket].size());
+    m_buckets[bucket].push_back(entry);
+
+    if (m_minZ > m_maxZ) {
+        m_minZ = pos->z;
+        m_maxZ = pos->z;
+    } else {
+        m_minZ = std::min(m_minZ, pos->z);
+        m_maxZ = std::max(m_maxZ, pos->z);
+    }
+}
+
+void DrawableGridClass::Erase(Drawable *draw)
+{
+    std::vector<EntryStruct> &bucket = m_buckets[draw->m_gridBucket];
+    int slot = draw->m_gridSlot;
+
+    // The last entry of the bucket fills the hole.
+    bucket[slot] = bucket.back();
+    bucket[slot].m_drawable->m_gridSlot = slot;
+    bucket.pop_back();
+    draw->m_gridBucket = -1;
+}
+
+void DrawableGridClass::Add(Drawable *draw)
+{
+    captainslog_dbgassert(draw->m_gridBucket == -1, "Drawable is already in the grid");
+    Insert(draw, m_nextSequence++);
+    ++m_count;
+}
+
+void DrawableGridClass::Remove(Drawable *draw)
+{
+    if (draw->m_gridBucket != -1) {
+        Erase(draw);
+        --m_count;
+    }
+}
+
+/**
+ * @brief Moves a drawable to the bucket of its current position, drawables that were never added are left alone.
+ */
+void DrawableGridClass::Update(Drawable *draw)
+{
+    if (draw->m_gridBucket == -1) {
+        return;
+    }
+
+    const Coord3D *pos = draw->Get_Position();
+    int bucket = Get_Bucket(pos->x, pos->y);
+
+    if (bucket == draw->m_gridBucket) {
+        EntryStruct &entry = m_buckets[bucket][draw->m_gridSlot];
+        entry.m_x = pos->x;
+        entry.m_y = pos->y;
+        m_minZ = std::min(m_minZ, pos->z);
+        m_maxZ = std::max(m_maxZ, pos->z);
+        return;
+    }
+
+    uint32_t sequence = m_buckets[draw->m_gridBucket][draw->m_gridSlot].m_sequence;
+    Erase(draw);
+    Insert(draw, sequence);
+}
+
+/**
+ * @brief Collects the drawables positioned inside a world XY region, in the order the game client list has them.
+ */
+void DrawableGridClass::Collect(const Region2D &region, std::vector<Drawable *> &drawables)
+{
+    drawables.clear();
+    m_collected.clear();
+
+    if (m_count == 0) {
+        return;
+    }
+
+    // Every bucket gets looked at once per query even when several cells of the region hash to it.
+    if (++m_stamp == 0) {
+        std::fill(m_bucketStamps.begin(), m_bucketStamps.end(), 0);
+        m_stamp = 1;
+    }
+
+    float cells_x = floorf(region.hi.x / GRID_CELL_SIZE) - floorf(region.lo.x / GRID_CELL_SIZE) + 1.0f;
+    float cells_y = floorf(region.hi.y / GRID_CELL_SIZE) - floorf(region.lo.y / GRID_CELL_SIZE) + 1.0f;
+
+    if (cells_x * cells_y >= float(GRID_BUCKET_COUNT)) {
+        // The region covers more cells than there are buckets, so just go through them all.
+        for (const auto &bucket : m_buckets) {
+            for (const EntryStruct &entry : bucket) {
+                if (entry.m_x >= region.lo.x && entry.m_x <= region.hi.x && entry.m_y >= region.lo.y
+                    && entry.m_y <= region.hi.y) {
+                    m_collected.push_back(entry);
+                }
+            }
+        }
+    } else {
+        int lo_x = Get_Cell(region.lo.x);
+        int lo_y = Get_Cell(region.lo.y);
+        int hi_x = Get_Cell(region.hi.x);
+        int hi_y = Get_Cell(region.hi.y);
+
+        for (int y = lo_y; y <= hi_y; ++y) {
+            for (int x = lo_x; x <= hi_x; ++x) {
+                int bucket_index = Hash_Cell(x, y);
+
+                if (m_bucketStamps[bucket_index] == m_stamp) {
+                    continue;
+                }
+
+                m_bucketStamps[bucket_index] = m_stamp;
+
+                for (const EntryStruct &entry : m_buckets[bucket_index]) {
+                    if (entry.m_x >= region.lo.x && entry.m_x <= region.hi.x && entry.m_y >= region.lo.y
+                        && entry.m_y <= region.hi.y) {
+                        m_collected.push_back(entry);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(m_collected.begin(), m_collected.end(), SequenceGreater());
+
+    for (const EntryStruct &entry : m_collected) {
+        drawables.push_back(entry.m_drawable);
+    }
+}
+
+/**
+ * @brief Gets the lowest and highest Z of any drawable added since the last reset, returning false if there were none.
+ */
+bool DrawableGridClass::Get_Height_Range(float &min_z, float &max_z) const
+{
+    if (m_count == 0 || m_minZ > m_maxZ) {
+        return false;
+    }
+
+    min_z = m_minZ;
+    max_z = m_maxZ;
+    return true;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Buckets drawables by their world position so screen regions only have to look at the ones nearby.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#pragma once
+
+#include "always.h"
+#include "coord.h"
+#include <vector>
+
+class Drawable;
+
+// Drawables are kept in a uniform grid over the world XY plane, hashed into a fixed number of buckets so the grid
+// needs no map bounds. Each drawable remembers its bucket and slot so moves and removals are constant time, and gets a
+// sequence number when added so that whatever is collected can be put back in the order of the game client drawable
+// list, which has the newest drawable first. The lowest and highest Z ever seen are kept so a view volume can be cut
+// down to the heights drawables actually occupy.
+class DrawableGridClass
+{
+public:
+    DrawableGridClass();
+
+    void Reset();
+    void Add(Drawable *draw);
+    void Remove(Drawable *draw);
+    void Update(Drawable *draw);
+
+    void Collect(const Region2D &region, std::vector<Drawable *> &drawables);
+    bool Get_Height_Range(float &min_z, float &max_z) const;
+    int Get_Count() const { return m_count; }
+
+private:
+    struct EntryStruct
+    {
+        Drawable *m_drawable;
+        uint32_t m_sequence;
+        float m_x;
+        float m_y;
+    };
+
+    int Get_Bucket(float x, float y) const;
+    void Insert(Drawable *draw, uint32_t sequence);
+    void Erase(Drawable *draw);
+
+    std::vector<std::vector<EntryStruct>> m_buckets;
+    std::vector<uint32_t> m_bucketStamps;
+    std::vector<EntryStruct> m_collected;
+    uint32_t m_stamp;
+    uint32_t m_nextSequence;
+    int m_count;
+    float m_minZ;
+    float m_maxZ;
+};
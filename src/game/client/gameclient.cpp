@@ -404,6 +404,9 @@ void GameClient::Reset()
     }
 
     m_drawableList = nullptr;
+#ifndef GAME_DLL
+    m_drawableGrid.Reset();
+#endif
     g_theDisplay->Reset();
     g_theTerrainVisual->Reset();
     g_theRayEffects->Reset();
@@ -596,6 +599,9 @@ void GameClient::Register_Drawable(Drawable *drawable)
 {
     drawable->Set_ID(Alloc_Drawable_ID());
     drawable->Prepend_To_List(&m_drawableList);
+#ifndef GAME_DLL
+    m_drawableGrid.Add(drawable);
+#endif
 }
 
 Drawable *GameClient::Find_Drawable_By_ID(DrawableID id)
@@ -650,6 +656,9 @@ void GameClient::Destroy_Drawable(Drawable *drawable)
 {
     g_theInGameUI->Disregard_Drawable(drawable);
     drawable->Remove_From_List(&m_drawableList);
+#ifndef GAME_DLL
+    m_drawableGrid.Remove(drawable);
+#endif
 
     Object *obj = drawable->Get_Object();
 
@@ -18,6 +18,7 @@
 #include "always.h"
 #include "asciistring.h"
 #include "coord.h"
+#include "drawablegrid.h"
 #include "gamemessage.h"
 #include "gametype.h"
 #include "messagestream.h"
@@ -180,6 +181,9 @@ public:
     int Get_On_Screen_Object_Count() { return m_onScreenObjectCount; }
     void Reset_On_Screen_Object_Count() { m_onScreenObjectCount = 0; }
     void Add_On_Screen_Object() { m_onScreenObjectCount++; }
+#ifndef GAME_DLL
+    DrawableGridClass &Get_Drawable_Grid() { return m_drawableGrid; }
+#endif
 
 protected:
     uint32_t m_frame;
@@ -192,6 +196,9 @@ protected:
     int m_onScreenObjectCount;
     std::list<DrawableTOCEntry> m_drawableTOC;
     std::list<Drawable *> m_drawableTB; // Text Bearing drawables.
+#ifndef GAME_DLL
+    DrawableGridClass m_drawableGrid;
+#endif
 };
 
 #ifdef GAME_DLL
@@ -50,6 +50,7 @@ public:
     float Get_Alpha() const { return m_alpha; }
     const RGBColor *Get_Color() const { return &m_color; }
     uint32_t Get_ID() const { return m_particleID; }
+    Particle *Get_System_Next() const { return m_systemNext; }
 
     void Set_ID(uint32_t id) { m_particleID = id; }
 
@@ -164,6 +164,9 @@ ParticleSystem::~ParticleSystem()
     }
 
     m_attachedToDrawableID = INVALID_DRAWABLE_ID;
+#ifndef GAME_DLL
+    g_theParticleSystemManager->Move_Attached_System(m_systemID, m_attachedToObjectID, INVALID_OBJECT_ID);
+#endif
     m_attachedToObjectID = INVALID_OBJECT_ID;
 
     if (m_controlParticle != nullptr) {
@@ -181,8 +184,60 @@ ParticleSystem::~ParticleSystem()
  * 0x004CFB80
  */
 bool ParticleSystem::Update(int index)
+{
+    bool keep_alive;
+
+    if (!Update_Emission(index, keep_alive)) {
+        return keep_alive;
+    }
+
+    Update_Particles(nullptr);
+
+    return Finish_Update();
+}
+
+/**
+ * @brief Steps every particle of the system. Particles whose lifetime ran out or that became invisible are deleted, or
+ * added to expired for the caller to delete if it is given.
+ */
+void ParticleSystem::Update_Particles(std::vector<Particle *> *expired)
+{
+    Particle *particle = m_systemParticlesHead;
+
+    while (particle != nullptr) {
+        if (m_gravity != 0.0f) {
+            Coord3D force;
+            force.x = 0.0f;
+            force.y = 0.0f;
+            force.z = m_gravity;
+            particle->Apply_Force(force);
+        }
+
+        if (particle->Update()) {
+            particle = particle->m_systemNext;
+        } else {
+            Particle *old_particle = particle;
+            particle = particle->m_systemNext;
+
+            if (expired != nullptr) {
+                expired->push_back(old_particle);
+            } else {
+                old_particle->Delete_Instance();
+            }
+        }
+    }
+}
+
+/**
+ * @brief First part of Update, follows whatever the system is attached to and emits new particles.
+ *
+ * @return True if the particles should be stepped and Finish_Update called next, otherwise keep_alive holds the result
+ * of the update.
+ */
+bool ParticleSystem::Update_Emission(int index, bool &keep_alive)
 {
     if (!g_theWriteableGlobalData->m_useFX) {
+        keep_alive = false;
         return false;
     }
 
@@ -191,7 +246,8 @@ bool ParticleSystem::Update(int index)
             m_startTimestamp = g_theGameClient->Get_Frame();
         }
 
-        return true;
+        keep_alive = true;
+        return false;
     } else {
         if (m_windMotion != WIND_MOTION_UNUSED) {
             Update_Wind_Motion();
@@ -233,6 +289,9 @@ bool ParticleSystem::Update(int index)
                 m_lastPos = m_pos;
                 m_pos = *object->Get_Position();
             } else {
+#ifndef GAME_DLL
+                g_theParticleSystemManager->Move_Attached_System(m_systemID, m_attachedToObjectID, INVALID_OBJECT_ID);
+#endif
                 m_attachedToObjectID = INVALID_OBJECT_ID;
                 Destroy();
             }
@@ -316,44 +375,34 @@ bool ParticleSystem::Update(int index)
             }
         }
 
-        Particle *particle = m_systemParticlesHead;
-
-        while (particle != nullptr) {
-            if (m_gravity != 0.0f) {
-                Coord3D force;
-                force.x = 0.0f;
-                force.y = 0.0f;
-                force.z = m_gravity;
-                particle->Apply_Force(force);
-            }
-
-            if (particle->Update()) {
-                particle = particle->m_systemNext;
-            } else {
-                Particle *old_particle = particle;
-                particle = particle->m_systemNext;
-                old_particle->Delete_Instance();
-            }
-        }
-
-        if (m_isDestroyed && m_systemParticlesHead == nullptr) {
-            return false;
-        }
+        return true;
+    }
+}
 
-        if (m_isForever) {
-            return true;
-        }
+/**
+ * @brief Last part of Update once the particles have been stepped.
+ *
+ * @return False if the system has finished and can be deleted.
+ */
+bool ParticleSystem::Finish_Update()
+{
+    if (m_isDestroyed && m_systemParticlesHead == nullptr) {
+        return false;
+    }
 
-        if (m_systemLifetimeLeft != 0) {
-            m_systemLifetimeLeft--;
-        }
+    if (m_isForever) {
+        return true;
+    }
 
-        if (Get_Particle_Count() != 0) {
-            return true;
-        }
+    if (m_systemLifetimeLeft != 0) {
+        m_systemLifetimeLeft--;
+    }
 
-        return m_systemLifetimeLeft != 0;
+    if (Get_Particle_Count() != 0) {
+        return true;
     }
+
+    return m_systemLifetimeLeft != 0;
 }
 
 /**
@@ -554,11 +603,19 @@ void ParticleSystem::Attach_To_Drawable(const Drawable *drawable)
  */
 void ParticleSystem::Attach_To_Object(const Object *object)
 {
+#ifndef GAME_DLL
+    ObjectID previous = m_attachedToObjectID;
+#endif
+
     if (object != nullptr) {
         m_attachedToObjectID = object->Get_ID();
     } else {
         m_attachedToObjectID = INVALID_OBJECT_ID;
     }
+
+#ifndef GAME_DLL
+    g_theParticleSystemManager->Move_Attached_System(m_systemID, previous, m_attachedToObjectID);
+#endif
 }
 
 /**
@@ -797,6 +854,13 @@ Particle *ParticleSystem::Create_Particle(const ParticleInfo &info, ParticlePrio
         return NEW_POOL_OBJ(Particle, this, info);
     }
 
+#ifndef GAME_DLL
+    if (g_theParticleSystemManager->Get_Particle_Count() > g_theWriteableGlobalData->m_maxParticleCount) {
+        // Culling needs the count and particle lists the serial update would have at this point.
+        g_theParticleSystemManager->Flush_Particle_Updates();
+    }
+#endif
+
     int excess = g_theParticleSystemManager->Get_Particle_Count() - g_theWriteableGlobalData->m_maxParticleCount;
 
     if (excess > 0 && g_theParticleSystemManager->Remove_Oldest_Particles(excess, priority) != unsigned(excess)) {
@@ -19,6 +19,7 @@
 #include "mempoolobj.h"
 #include "particlesysinfo.h"
 #include "particlesysmanager.h"
+#include <vector>
 
 class Particle;
 class ParticleInfo;
@@ -60,6 +61,9 @@ public:
     void Attach_To_Object(const Object *object);
     void Add_Particle(Particle *particle);
     void Remove_Particle(Particle *particle);
+    bool Update_Emission(int index, bool &keep_alive);
+    void Update_Particles(std::vector<Particle *> *expired);
+    bool Finish_Update();
 
     void Set_Lifetime_Range(float min, float max) { m_lifetime.Set_Range(min, max, GameClientRandomVariable::UNIFORM); }
     void Set_Unk(bool set) { m_unkBool1 = set; }
@@ -107,6 +111,7 @@ public:
     const ParticleSystemTemplate *Get_Template() const { return m_template; }
     const ParticleSystem *Get_Slave() const { return m_slaveSystem; }
     const ParticleSystem *Get_Master() const { return m_masterSystem; }
+    Particle *Get_Control_Particle() const { return m_controlParticle; }
     uint32_t Get_Particle_Count() const { return m_particleCount; }
     const Coord3D *Get_Slave_Position_Offset() const { return &m_slavePosOffset; }
 
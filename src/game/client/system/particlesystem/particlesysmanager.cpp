@@ -14,20 +14,65 @@
  */
 #include "particlesysmanager.h"
 #include "display.h"
+#include "fpusetting.h"
+#include "gameclient.h"
 #include "gamelogic.h"
+#include "globaldata.h"
 #include "ini.h"
 #include "object.h"
 #include "particle.h"
 #include "particlesys.h"
 #include "particlesystemplate.h"
 #include "xfer.h"
+#include <algorithm>
 #include <captainslog.h>
+#ifndef GAME_DLL
+#include <thread>
+#endif
 
 #ifdef GAME_DLL
 #else
 ParticleSystemManager *g_theParticleSystemManager;
 #endif
 
+#ifndef GAME_DLL
+namespace
+{
+enum
+{
+    WORKER_STOP_TIMEOUT = 1000,
+};
+
+/**
+ * @brief Number of update workers for this machine, one less than its hardware threads so the calling thread has one
+ * of its own. hardware_concurrency returns 0 when unknown, which also gives no workers.
+ */
+int Get_Update_Worker_Count()
+{
+    int threads = std::thread::hardware_concurrency();
+
+    return std::clamp(threads - 1, 0, int(ParticleSystemManager::MAX_UPDATE_WORKERS));
+}
+} // namespace
+
+ParticleUpdateWorkerThreadClass::ParticleUpdateWorkerThreadClass(ParticleSystemManager *manager) :
+    ThreadClass("ParticleUpdateWorkerThread", nullptr), m_manager(manager)
+{
+}
+
+void ParticleUpdateWorkerThreadClass::Thread_Function()
+{
+    size_t index;
+
+    // The main thread sets the x87 precision when loading INI files and the particle maths must match its results.
+    Set_FP_Mode();
+
+    while (m_manager->Wait_For_Particle_Update(index)) {
+        m_manager->Run_Particle_Update(index);
+    }
+}
+#endif
+
 /**
  * 0x004D1790
  */
@@ -41,6 +86,17 @@ ParticleSystemManager::ParticleSystemManager() :
     m_frame(0),
     m_playerIndex(0),
     m_templateStore()
+#ifndef GAME_DLL
+    ,
+    m_serialUpdate(false),
+    m_updateWorkerCount(Get_Update_Worker_Count()),
+    m_pendingHead(0),
+    m_pendingCount(0),
+    m_nextUpdateJob(0),
+    m_endUpdateJob(0),
+    m_runningUpdateJobs(0),
+    m_stopUpdateWorkers(false)
+#endif
 {
     for (int i = 0; i < PARTICLE_PRIORITY_COUNT; ++i) {
         m_allParticlesHead[i] = nullptr;
@@ -53,6 +109,9 @@ ParticleSystemManager::ParticleSystemManager() :
  */
 ParticleSystemManager::~ParticleSystemManager()
 {
+#ifndef GAME_DLL
+    Stop_Update_Workers();
+#endif
     Reset();
 }
 
@@ -105,6 +164,10 @@ void ParticleSystemManager::Reset()
     m_particleSystemCount = 0;
     m_uniqueSystemID = PARTSYS_ID_NONE;
     m_frame = -1;
+#ifndef GAME_DLL
+    m_systemsByID.clear();
+    m_attachedSystemIDs.clear();
+#endif
 }
 
 /**
@@ -117,6 +180,13 @@ void ParticleSystemManager::Update()
     if (m_frame != g_theGameLogic->Get_Frame()) {
         m_frame = g_theGameLogic->Get_Frame();
 
+#ifndef GAME_DLL
+        if (!m_serialUpdate && m_updateWorkerCount > 0 && g_theWriteableGlobalData->m_useFX) {
+            Update_Parallel();
+            return;
+        }
+#endif
+
         for (auto it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end();) {
             ParticleSystem *system = *it;
 
@@ -132,6 +202,201 @@ void ParticleSystemManager::Update()
     }
 }
 
+#ifndef GAME_DLL
+/**
+ * @brief Update with the particle stepping of the systems spread over worker threads.
+ *
+ * Emission stays on this thread in list order since it draws from the client random sequence and may cull the oldest
+ * particles of any system. The stepping of each system is queued instead and run on the workers. Before a system's
+ * emission runs, every queued system it depends on is finished first: the system owning its control particle, whose
+ * position it follows and whose expiring particles may destroy it, its slave, which it emits particles into, and its
+ * master, since a slave only emits on its own once the master is gone.
+ * Everything is also finished before particles are culled for the particle cap, so the counts seen are those of the
+ * serial update. Queued systems are always finished in list order, so the result is identical to Update with
+ * m_serialUpdate set. The calling thread takes jobs as well, so this still works without any workers.
+ */
+void ParticleSystemManager::Update_Parallel()
+{
+    if (m_updateWorkers.empty()) {
+        for (int i = 0; i < m_updateWorkerCount; ++i) {
+            ParticleUpdateWorkerThreadClass *worker = new ParticleUpdateWorkerThreadClass(this);
+            worker->Execute();
+            m_updateWorkers.push_back(worker);
+        }
+    }
+
+    for (auto it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end();) {
+        ParticleSystem *system = *it;
+        it++;
+
+        if (system == nullptr) {
+            continue;
+        }
+
+        if (system->Get_Control_Particle() != nullptr) {
+            Flush_Particle_Updates_Through(system->Get_Control_Particle()->m_system);
+        }
+
+        if (system->Get_Slave() != nullptr) {
+            Flush_Particle_Updates_Through(system->Get_Slave());
+        }
+
+        if (system->Get_Master() != nullptr) {
+            Flush_Particle_Updates_Through(system->Get_Master());
+        }
+
+        bool keep_alive;
+
+        if (!system->Update_Emission(m_playerIndex, keep_alive)) {
+            if (!keep_alive) {
+                system->Delete_Instance();
+            }
+
+            continue;
+        }
+
+        if (m_pendingCount == m_pendingUpdates.size()) {
+            m_pendingUpdates.push_back(PendingUpdate());
+        }
+
+        m_pendingUpdates[m_pendingCount].system = system;
+        m_pendingUpdates[m_pendingCount].expired.clear();
+        m_pendingIndex[system] = m_pendingCount;
+        m_pendingCount++;
+    }
+
+    Flush_Particle_Updates();
+}
+
+/**
+ * @brief Finishes the update of every queued system.
+ */
+void ParticleSystemManager::Flush_Particle_Updates()
+{
+    if (m_pendingHead < m_pendingCount) {
+        Flush_Particle_Updates_Through(m_pendingCount - 1);
+    }
+}
+
+void ParticleSystemManager::Flush_Particle_Updates_Through(const ParticleSystem *system)
+{
+    auto it = m_pendingIndex.find(system);
+
+    if (it != m_pendingIndex.end() && it->second >= m_pendingHead) {
+        Flush_Particle_Updates_Through(it->second);
+    }
+}
+
+/**
+ * @brief Steps the particles of the queued systems up to and including index, then deletes the particles that expired
+ * and finishes each system's update in list order.
+ */
+void ParticleSystemManager::Flush_Particle_Updates_Through(size_t index)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_updateLock);
+        m_nextUpdateJob = m_pendingHead;
+        m_endUpdateJob = index + 1;
+    }
+
+    m_updateQueued.notify_all();
+    size_t job;
+
+    while (Claim_Particle_Update(job)) {
+        Run_Particle_Update(job);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_updateLock);
+        m_updateDone.wait(lock, [this] { return m_runningUpdateJobs == 0; });
+    }
+
+    for (size_t i = m_pendingHead; i <= index; ++i) {
+        PendingUpdate &pending = m_pendingUpdates[i];
+
+        for (Particle *particle : pending.expired) {
+            particle->Delete_Instance();
+        }
+
+        pending.expired.clear();
+        m_pendingIndex.erase(pending.system);
+
+        if (!pending.system->Finish_Update()) {
+            pending.system->Delete_Instance();
+        }
+    }
+
+    m_pendingHead = index + 1;
+
+    if (m_pendingHead == m_pendingCount) {
+        m_pendingHead = 0;
+        m_pendingCount = 0;
+    }
+}
+
+bool ParticleSystemManager::Claim_Particle_Update(size_t &index)
+{
+    std::lock_guard<std::mutex> lock(m_updateLock);
+
+    if (m_nextUpdateJob >= m_endUpdateJob) {
+        return false;
+    }
+
+    index = m_nextUpdateJob++;
+    m_runningUpdateJobs++;
+
+    return true;
+}
+
+/**
+ * @brief Blocks a worker until a job is handed out and claims it. Returns false once the workers should stop.
+ */
+bool ParticleSystemManager::Wait_For_Particle_Update(size_t &index)
+{
+    std::unique_lock<std::mutex> lock(m_updateLock);
+    m_updateQueued.wait(lock, [this] { return m_stopUpdateWorkers || m_nextUpdateJob < m_endUpdateJob; });
+
+    if (m_stopUpdateWorkers) {
+        return false;
+    }
+
+    index = m_nextUpdateJob++;
+    m_runningUpdateJobs++;
+
+    return true;
+}
+
+void ParticleSystemManager::Run_Particle_Update(size_t index)
+{
+    PendingUpdate &pending = m_pendingUpdates[index];
+    pending.system->Update_Particles(&pending.expired);
+
+    std::lock_guard<std::mutex> lock(m_updateLock);
+
+    if (--m_runningUpdateJobs == 0) {
+        m_updateDone.notify_one();
+    }
+}
+
+void ParticleSystemManager::Stop_Update_Workers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_updateLock);
+        m_stopUpdateWorkers = true;
+    }
+
+    m_updateQueued.notify_all();
+
+    for (auto it = m_updateWorkers.begin(); it != m_updateWorkers.end(); ++it) {
+        (*it)->Stop(WORKER_STOP_TIMEOUT);
+        delete *it;
+    }
+
+    m_updateWorkers.clear();
+    m_stopUpdateWorkers = false;
+}
+#endif
+
 /**
  * @brief Xfer this Snapshot object.
  *
@@ -176,7 +441,21 @@ void ParticleSystemManager::Xfer_Snapshot(Xfer *xfer)
                     6,
                     "ParticleSystemManager::Xfer_Snapshot - Unable to allocate particle system '%s'",
                     name.Str());
+#ifndef GAME_DLL
+                ParticleSystemID created_id = system->Get_System_ID();
+#endif
                 xfer->xferSnapshot(system);
+#ifndef GAME_DLL
+                // The snapshot restores the saved id and attachment over the ones the system was indexed under.
+                auto found = m_systemsByID.find(created_id);
+
+                if (found != m_systemsByID.end() && found->second == system) {
+                    m_systemsByID.erase(found);
+                }
+
+                m_systemsByID[system->Get_System_ID()] = system;
+                Move_Attached_System(system->Get_System_ID(), INVALID_OBJECT_ID, system->Get_Attached_Object());
+#endif
             }
         }
     }
@@ -260,11 +539,19 @@ ParticleSystem *ParticleSystemManager::Create_Particle_System(const ParticleSyst
 ParticleSystem *ParticleSystemManager::Find_Particle_System(ParticleSystemID id) const
 {
     if (id != PARTSYS_ID_NONE) {
+#ifdef GAME_DLL
         for (auto it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end(); ++it) {
             if ((*it)->Get_System_ID() == id) {
                 return *it;
             }
         }
+#else
+        auto it = m_systemsByID.find(id);
+
+        if (it != m_systemsByID.end()) {
+            return it->second;
+        }
+#endif
     }
 
     return nullptr;
@@ -292,6 +579,22 @@ void ParticleSystemManager::Destroy_Particle_System_By_ID(ParticleSystemID id)
 void ParticleSystemManager::Destroy_Attached_Systems(Object *object)
 {
     if (object != nullptr) {
+#ifndef GAME_DLL
+        auto attached = m_attachedSystemIDs.find(object->Get_ID());
+
+        if (attached == m_attachedSystemIDs.end()) {
+            return;
+        }
+
+        // Destroy only flags the systems so the id list stays valid while it is walked.
+        for (ParticleSystemID id : attached->second) {
+            ParticleSystem *system = Find_Particle_System(id);
+
+            if (system != nullptr && system->Get_Attached_Object() == object->Get_ID()) {
+                system->Destroy();
+            }
+        }
+#else
         ParticleSystem *system = nullptr;
 
         for (auto it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end(); it++) {
@@ -303,6 +606,7 @@ void ParticleSystemManager::Destroy_Attached_Systems(Object *object)
                 }
             }
         }
+#endif
     }
 }
 
@@ -358,6 +662,9 @@ void ParticleSystemManager::Add_Particle_System(ParticleSystem *system)
 
     m_allParticleSystemList.push_back(system);
     ++m_particleSystemCount;
+#ifndef GAME_DLL
+    m_systemsByID.insert({ system->Get_System_ID(), system });
+#endif
 }
 
 /**
@@ -407,8 +714,50 @@ void ParticleSystemManager::Remove_Particle_System(ParticleSystem *system)
             break;
         }
     }
+
+#ifndef GAME_DLL
+    auto it = m_systemsByID.find(system->Get_System_ID());
+
+    if (it != m_systemsByID.end() && it->second == system) {
+        m_systemsByID.erase(it);
+    }
+#endif
 }
 
+#ifndef GAME_DLL
+/**
+ * @brief Moves a system id between the per object lists Destroy_Attached_Systems works from.
+ */
+void ParticleSystemManager::Move_Attached_System(ParticleSystemID id, ObjectID from, ObjectID to)
+{
+    if (from == to) {
+        return;
+    }
+
+    if (from != INVALID_OBJECT_ID) {
+        auto it = m_attachedSystemIDs.find(from);
+
+        if (it != m_attachedSystemIDs.end()) {
+            std::vector<ParticleSystemID> &ids = it->second;
+            auto found = std::find(ids.begin(), ids.end(), id);
+
+            if (found != ids.end()) {
+                *found = ids.back();
+                ids.pop_back();
+            }
+
+            if (ids.empty()) {
+                m_attachedSystemIDs.erase(it);
+            }
+        }
+    }
+
+    if (to != INVALID_OBJECT_ID) {
+        m_attachedSystemIDs[to].push_back(id);
+    }
+}
+#endif
+
 /**
  * @brief Removes count number of the oldest particles the manager knows about.
  */
@@ -16,6 +16,11 @@
 
 #include "always.h"
 #include "gametype.h"
+#ifndef GAME_DLL
+#include "thread.h"
+#include <condition_variable>
+#include <mutex>
+#endif
 #include "rtsutils.h"
 #include "snapshot.h"
 #include "subsysteminterface.h"
@@ -49,8 +54,37 @@ enum ParticleSystemID : int32_t
 };
 DEFINE_ENUMERATION_OPERATORS(ParticleSystemID);
 
+#ifndef GAME_DLL
+class ParticleSystemManager;
+
+class ParticleUpdateWorkerThreadClass : public ThreadClass
+{
+public:
+    ParticleUpdateWorkerThreadClass(ParticleSystemManager *manager);
+    virtual ~ParticleUpdateWorkerThreadClass() {}
+
+    virtual void Thread_Function() override;
+
+private:
+    ParticleSystemManager *m_manager;
+};
+#endif
+
 class ParticleSystemManager : public SubsystemInterface, public SnapShot
 {
+#ifndef GAME_DLL
+    friend class ParticleUpdateWorkerThreadClass;
+
+public:
+    // Workers are sized from the hardware threads, leaving one for the calling thread which runs emission and takes
+    // jobs too. Beyond this many the emission and flushes on the calling thread are the limit, so more only add
+    // contention.
+    enum
+    {
+        MAX_UPDATE_WORKERS = 7,
+    };
+
+#endif
 public:
     ParticleSystemManager();
     virtual ~ParticleSystemManager();
@@ -80,6 +114,9 @@ public:
     void Add_Particle_System(ParticleSystem *system);
     void Remove_Particle(Particle *particle);
     void Remove_Particle_System(ParticleSystem *system);
+#ifndef GAME_DLL
+    void Move_Attached_System(ParticleSystemID id, ObjectID from, ObjectID to);
+#endif
     int Get_Particle_Count() const { return m_particleCount; }
     int Get_Field_Particle_Count() const { return m_fieldParticleCount; }
     Particle *Get_Particle_Head(ParticlePriorityType priority) { return m_allParticlesHead[priority]; }
@@ -89,6 +126,11 @@ public:
     partsystempmap_t::iterator Get_Ending_Template() { return m_templateStore.end(); }
     std::list<ParticleSystem *> &Get_All_Particle_Systems() { return m_allParticleSystemList; }
     unsigned int Get_Particle_System_Count() { return m_particleSystemCount; }
+#ifndef GAME_DLL
+    void Set_Serial_Update(bool serial) { m_serialUpdate = serial; }
+    bool Is_Serial_Update() const { return m_serialUpdate; }
+    void Flush_Particle_Updates();
+#endif
 
     void Set_Player_Index(unsigned int index) { m_playerIndex = index; }
 
@@ -109,6 +151,41 @@ protected:
     int m_frame;
     unsigned int m_playerIndex;
     partsystempmap_t m_templateStore;
+#ifndef GAME_DLL
+    // Lookups by id and by attached object are frequent enough that walking the system list each time shows up.
+    std::unordered_map<int32_t, ParticleSystem *> m_systemsByID;
+    std::unordered_map<ObjectID, std::vector<ParticleSystemID>> m_attachedSystemIDs;
+
+    // Systems whose particles still need stepping this frame, in update order. Entries before m_pendingHead are done.
+    struct PendingUpdate
+    {
+        ParticleSystem *system;
+        std::vector<Particle *> expired;
+    };
+
+    void Update_Parallel();
+    void Flush_Particle_Updates_Through(const ParticleSystem *system);
+    void Flush_Particle_Updates_Through(size_t index);
+    bool Claim_Particle_Update(size_t &index);
+    bool Wait_For_Particle_Update(size_t &index);
+    void Run_Particle_Update(size_t index);
+    void Stop_Update_Workers();
+
+    bool m_serialUpdate;
+    int m_updateWorkerCount; // Zero on a single hardware thread, where Update always runs serially.
+    std::vector<PendingUpdate> m_pendingUpdates;
+    size_t m_pendingHead;
+    size_t m_pendingCount;
+    std::unordered_map<const ParticleSystem *, size_t> m_pendingIndex;
+    size_t m_nextUpdateJob;
+    size_t m_endUpdateJob;
+    size_t m_runningUpdateJobs;
+    bool m_stopUpdateWorkers;
+    std::mutex m_updateLock;
+    std::condition_variable m_updateQueued; // Signalled when jobs are handed out or the workers should stop.
+    std::condition_variable m_updateDone; // Signalled when the last running job finishes.
+    std::vector<ParticleUpdateWorkerThreadClass *> m_updateWorkers;
+#endif
 };
 
 #ifdef GAME_DLL
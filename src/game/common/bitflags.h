@@ -19,6 +19,7 @@
 #include "ini.h"
 #include "xfer.h"
 #include <bitset>
+#include <cstring>
 
 template<int> class BitFlags;
 
@@ -212,6 +213,11 @@ public:
         kInit = 0,
     };
 
+    enum
+    {
+        WORD_COUNT = sizeof(std::bitset<bits>) / sizeof(uint32_t),
+    };
+
     BitFlags() {}
     BitFlags(BogusInitType type, int flag) { m_bits.set(flag); }
     BitFlags(BogusInitType type, int flag1, int flag2)
@@ -406,6 +412,10 @@ public:
         return flags;
     }
 
+    // Copies out the raw storage, flag n being bit n % 32 of word n / 32 as the storage is little endian words on every
+    // target the game runs on. Bits past the last flag are always clear.
+    void Get_Words(uint32_t *words) const { memcpy(words, &m_bits, sizeof(m_bits)); }
+
     static const char *Bit_As_String(int bit)
     {
         if (bit < 0 || bit >= bits) {
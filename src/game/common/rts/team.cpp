@@ -675,6 +675,10 @@ Team::Team(TeamPrototype *proto, unsigned int id) :
 
     if (proto != nullptr) {
         proto->Prepend_To_Team_Instance_List(this);
+        if (g_theScriptEngine != nullptr) {
+            g_theScriptEngine->Notify_Of_Object_State_Change();
+        }
+
         const TeamTemplateInfo *info = proto->Get_Template_Info();
 
         if (!info->m_scriptOnAllClear.Is_Empty() || !info->m_scriptOnEnemySighted.Is_Empty()) {
@@ -687,6 +691,17 @@ Team::Team(TeamPrototype *proto, unsigned int id) :
     }
 }
 
+void Team::Set_Active()
+{
+    if (!m_active) {
+        m_created = true;
+        m_active = true;
+        if (g_theScriptEngine != nullptr) {
+            g_theScriptEngine->Notify_Of_Object_State_Change();
+        }
+    }
+}
+
 Team::~Team()
 {
     g_theScriptEngine->Notify_Of_Team_Destruction(this);
@@ -1323,6 +1338,11 @@ bool Team::Has_Any_Objects() const
 
 void Team::Update_State()
 {
+    if (m_enteredOrExited && g_theScriptEngine != nullptr) {
+        // All_Inside and None_Inside only report while this is set.
+        g_theScriptEngine->Notify_Of_Trigger_Area_Change();
+    }
+
     m_enteredOrExited = false;
 
     if (m_active) {
@@ -356,13 +356,7 @@ public:
         m_availableForRecruitment = available;
     }
 
-    void Set_Active()
-    {
-        if (!m_active) {
-            m_created = true;
-            m_active = true;
-        }
-    }
+    void Set_Active();
 
 private:
     struct DLINKHEAD_TeamMemberList
@@ -16,9 +16,11 @@
 
 #include "always.h"
 #include <map>
+#include <vector>
 
 template<typename Type, typename Key> class SparseMatchFinder
 {
+#ifdef GAME_DLL
     class MapHelper
     {
     public:
@@ -132,4 +134,212 @@ private:
     }
 
     mutable std::map<Key const, const Type *, MapHelper> m_bestMatches;
+#else
+    // Keys are handled as their raw bitset words. Results are cached in an open addressing table keyed on the words
+    // and misses score every condition set of the vector, packed into one flat array on first use, with a popcount per
+    // word. The intersection with a condition set is popcount(key & set) and the inverse intersection is what is left
+    // of the set, so both counts come out of a single pass.
+    enum
+    {
+        WORD_COUNT = Key::WORD_COUNT,
+        INITIAL_CACHE_SIZE = 64,
+    };
+
+    struct CandidateStruct
+    {
+        uint32_t m_words[WORD_COUNT];
+        int m_count;
+        int m_index;
+    };
+
+    struct CacheEntryStruct
+    {
+        uint32_t m_words[WORD_COUNT];
+        int m_index; // -1 for free slots.
+    };
+
+public:
+    SparseMatchFinder() : m_compiledData(nullptr), m_compiledSize(0), m_cacheCount(0) {}
+
+    const Type *Find_Best_Info(std::vector<Type> const &vector, Key const &key) const
+    {
+        // Anything cached refers to the vector by index, so it all goes if the vector isn't the one compiled.
+        if (m_compiledData != vector.data() || m_compiledSize != vector.size()) {
+            Compile(vector);
+        }
+
+        uint32_t words[WORD_COUNT];
+        key.Get_Words(words);
+        uint32_t hash = Hash_Words(words);
+
+        if (m_cacheCount != 0) {
+            size_t mask = m_cache.size() - 1;
+
+            for (size_t slot = hash & mask; m_cache[slot].m_index != -1; slot = (slot + 1) & mask) {
+                if (memcmp(m_cache[slot].m_words, words, sizeof(words)) == 0) {
+                    return &vector[m_cache[slot].m_index];
+                }
+            }
+        }
+
+        int index = Find_Best_Index_Slow(vector, key, words);
+        captainslog_dbgassert(index != -1, "no suitable match for criteria was found!");
+
+        if (index == -1) {
+            return nullptr;
+        }
+
+        Insert(words, hash, index);
+
+        return &vector[index];
+    }
+
+    void Clear() { Reset(); }
+
+private:
+    static int Pop_Count(uint32_t value)
+    {
+#if defined __GNUC__ || defined __clang__
+        return __builtin_popcount(value);
+#else
+        value = value - ((value >> 1) & 0x55555555);
+        value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+        return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#endif
+    }
+
+    static uint32_t Hash_Words(const uint32_t *words)
+    {
+        uint32_t hash = 2166136261u;
+
+        for (int i = 0; i < WORD_COUNT; ++i) {
+            hash = (hash ^ words[i]) * 16777619u;
+        }
+
+        return hash ^ (hash >> 16);
+    }
+
+    void Reset() const
+    {
+        m_candidates.clear();
+        m_cache.clear();
+        m_compiledData = nullptr;
+        m_compiledSize = 0;
+        m_cacheCount = 0;
+    }
+
+    void Compile(std::vector<Type> const &vector) const
+    {
+        Reset();
+
+        // Same order the condition sets have always been searched in, as ties go to the first one found.
+        for (size_t i = 0; i < vector.size(); ++i) {
+            const Type &template_set = vector[i];
+
+            for (int condition_idx = template_set.Get_Conditions_Count() - 1; condition_idx >= 0; condition_idx--) {
+                CandidateStruct candidate;
+                template_set.Get_Conditions_Yes(condition_idx).Get_Words(candidate.m_words);
+                candidate.m_count = 0;
+                candidate.m_index = int(i);
+
+                for (int word = 0; word < WORD_COUNT; ++word) {
+                    candidate.m_count += Pop_Count(candidate.m_words[word]);
+                }
+
+                m_candidates.push_back(candidate);
+            }
+        }
+
+        m_compiledData = vector.data();
+        m_compiledSize = vector.size();
+    }
+
+    void Insert(const uint32_t *words, uint32_t hash, int index) const
+    {
+        // Keep the table at most half full so probe runs stay short.
+        if ((m_cacheCount + 1) * 2 > int(m_cache.size())) {
+            std::vector<CacheEntryStruct> old_cache;
+            old_cache.swap(m_cache);
+            CacheEntryStruct empty;
+            memset(empty.m_words, 0, sizeof(empty.m_words));
+            empty.m_index = -1;
+            m_cache.assign(old_cache.empty() ? size_t(INITIAL_CACHE_SIZE) : old_cache.size() * 2, empty);
+            m_cacheCount = 0;
+
+            for (const CacheEntryStruct &entry : old_cache) {
+                if (entry.m_index != -1) {
+                    Insert(entry.m_words, Hash_Words(entry.m_words), entry.m_index);
+                }
+            }
+        }
+
+        size_t mask = m_cache.size() - 1;
+        size_t slot = hash & mask;
+
+        while (m_cache[slot].m_index != -1) {
+            slot = (slot + 1) & mask;
+        }
+
+        memcpy(m_cache[slot].m_words, words, sizeof(m_cache[slot].m_words));
+        m_cache[slot].m_index = index;
+        ++m_cacheCount;
+    }
+
+    int Find_Best_Index_Slow(std::vector<Type> const &vector, Key const &key, const uint32_t *words) const
+    {
+        int best_match = -1;
+        // The higher the intersection count the better the match
+        int best_match_count = 0;
+        // The lower the inverse intersection count the better the match
+        int best_match_inv_count = 999;
+        int extramatches = 0;
+        int ambiguous_match = -1;
+
+        for (const CandidateStruct &candidate : m_candidates) {
+            int intersection_count = 0;
+
+            for (int word = 0; word < WORD_COUNT; ++word) {
+                intersection_count += Pop_Count(words[word] & candidate.m_words[word]);
+            }
+
+            int inverse_intersection_count = candidate.m_count - intersection_count;
+
+            if (intersection_count == best_match_count && inverse_intersection_count == best_match_inv_count) {
+                // We have at least two equally good matches!
+                // This is bad as it is ambiguous, hopefully there is a better match later in the search
+                extramatches++;
+                ambiguous_match = candidate.m_index;
+            }
+
+            // The higher the intersection count the better the match
+            // If of equal intersections then the lowest inverse intersections the better the match
+            if (intersection_count > best_match_count
+                || (intersection_count >= best_match_count && inverse_intersection_count < best_match_inv_count)) {
+                best_match = candidate.m_index;
+                best_match_count = intersection_count;
+                best_match_inv_count = inverse_intersection_count;
+                extramatches = 0;
+            }
+        }
+
+        if (extramatches > 0) {
+            Utf8String bits;
+            key.Get_Name_For_Bits(&bits);
+            captainslog_debug("ambiguous model match in findBestInfoSlow \n\nbetween \n(%s)\n<and>\n(%s)\n\n(%d extra "
+                              "matches found)\n\ncurrent bits are (\n%s)",
+                vector[best_match].Get_Definition().Str(),
+                vector[ambiguous_match].Get_Definition().Str(),
+                extramatches,
+                bits.Str());
+        }
+
+        return best_match;
+    }
+
+    mutable std::vector<CandidateStruct> m_candidates;
+    mutable std::vector<CacheEntryStruct> m_cache;
+    mutable const Type *m_compiledData;
+    mutable size_t m_compiledSize;
+    mutable int m_cacheCount;
+#endif
 };
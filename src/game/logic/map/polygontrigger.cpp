@@ -25,6 +25,10 @@ PolygonTrigger *PolygonTrigger::s_thePolygonTriggerListPtr = nullptr;
 #endif
 
 int PolygonTrigger::s_currentID = 1;
+#ifndef GAME_DLL
+TriggerAreaGrid PolygonTrigger::s_triggerAreaGrid;
+bool PolygonTrigger::s_triggerAreaGridDirty = true;
+#endif
 
 // BUGFIX initalize all variables
 PolygonTrigger::PolygonTrigger(int initial_allocation) :
@@ -83,6 +87,9 @@ void PolygonTrigger::Xfer_Snapshot(Xfer *xfer)
     xfer->xferIRegion2D(&m_bounds);
     xfer->xferReal(&m_radius);
     xfer->xferBool(&m_boundsNeedsUpdate);
+#ifndef GAME_DLL
+    s_triggerAreaGridDirty = true;
+#endif
 }
 
 void PolygonTrigger::Reallocate()
@@ -144,6 +151,9 @@ void PolygonTrigger::Add_Point(ICoord3D const &point)
     m_points[m_numPoints] = point;
     m_numPoints++;
     m_boundsNeedsUpdate = true;
+#ifndef GAME_DLL
+    s_triggerAreaGridDirty = true;
+#endif
 }
 
 void PolygonTrigger::Set_Point(ICoord3D const &point, int ndx)
@@ -156,6 +166,9 @@ void PolygonTrigger::Set_Point(ICoord3D const &point, int ndx)
         } else if (ndx <= m_numPoints) {
             m_points[ndx] = point;
             m_boundsNeedsUpdate = true;
+#ifndef GAME_DLL
+            s_triggerAreaGridDirty = true;
+#endif
         }
     }
 }
@@ -179,6 +192,9 @@ void PolygonTrigger::Insert_Point(ICoord3D const &point, int ndx)
             m_points[ndx] = point;
             m_numPoints++;
             m_boundsNeedsUpdate = true;
+#ifndef GAME_DLL
+            s_triggerAreaGridDirty = true;
+#endif
         }
     }
 }
@@ -194,6 +210,9 @@ void PolygonTrigger::Delete_Point(int ndx)
 
         m_numPoints--;
         m_boundsNeedsUpdate = true;
+#ifndef GAME_DLL
+        s_triggerAreaGridDirty = true;
+#endif
     }
 }
 
@@ -238,6 +257,9 @@ void PolygonTrigger::Add_Polygon_Trigger(PolygonTrigger *trigger)
 
     trigger->m_nextPolygonTrigger = s_thePolygonTriggerListPtr;
     s_thePolygonTriggerListPtr = trigger;
+#ifndef GAME_DLL
+    s_triggerAreaGridDirty = true;
+#endif
 }
 
 void PolygonTrigger::Remove_Polygon_Trigger(PolygonTrigger *trigger)
@@ -262,6 +284,9 @@ void PolygonTrigger::Remove_Polygon_Trigger(PolygonTrigger *trigger)
     }
 
     trigger->m_nextPolygonTrigger = nullptr;
+#ifndef GAME_DLL
+    s_triggerAreaGridDirty = true;
+#endif
 }
 
 PolygonTrigger *PolygonTrigger::Get_Polygon_Trigger_By_ID(int id)
@@ -386,6 +411,10 @@ bool PolygonTrigger::Parse_Polygon_Triggers_Data_Chunk(DataChunkInput &file, Dat
     }
 
     s_currentID = maxTriggerId + 1;
+#ifndef GAME_DLL
+    // Triggers are chained with Set_Next above so the list changed without going through Add_Polygon_Trigger.
+    s_triggerAreaGridDirty = true;
+#endif
     captainslog_dbgassert(file.At_End_Of_Chunk(), "Incorrect data file length.");
     return true;
 }
@@ -396,8 +425,29 @@ void PolygonTrigger::Delete_Triggers()
     s_thePolygonTriggerListPtr = nullptr;
     s_currentID = 1;
     p->Delete_Instance();
+#ifndef GAME_DLL
+    s_triggerAreaGridDirty = true;
+#endif
 }
 
+#ifndef GAME_DLL
+const TriggerAreaGrid &PolygonTrigger::Get_Trigger_Area_Grid()
+{
+    if (s_triggerAreaGridDirty) {
+        int cell_size = 40;
+
+        if (g_theWriteableGlobalData != nullptr && g_theWriteableGlobalData->m_partitionCellSize >= 1.0f) {
+            cell_size = (int)g_theWriteableGlobalData->m_partitionCellSize;
+        }
+
+        s_triggerAreaGrid.Build(s_thePolygonTriggerListPtr, cell_size);
+        s_triggerAreaGridDirty = false;
+    }
+
+    return s_triggerAreaGrid;
+}
+#endif
+
 // Seems to be related to https://wrf.ecse.rpi.edu/Research/Short_Notes/pnpoly.html
 bool PolygonTrigger::Point_In_Trigger(ICoord3D &point) const
 {
@@ -17,6 +17,9 @@
 #include "always.h"
 #include "datachunk.h"
 #include "terrainlogic.h"
+#ifndef GAME_DLL
+#include "triggerareagrid.h"
+#endif
 
 class PolygonTrigger : public MemoryPoolObject, public SnapShot
 {
@@ -93,6 +96,10 @@ public:
     static void Remove_Polygon_Trigger(PolygonTrigger *trigger);
     static PolygonTrigger *Get_Polygon_Trigger_By_ID(int id);
     static void Clear_Selected();
+#ifndef GAME_DLL
+    static const TriggerAreaGrid &Get_Trigger_Area_Grid();
+    static void Invalidate_Trigger_Area_Grid() { s_triggerAreaGridDirty = true; }
+#endif
 
 private:
 #ifdef GAME_DLL
@@ -101,6 +108,10 @@ private:
     static PolygonTrigger *s_thePolygonTriggerListPtr;
 #endif
     static int s_currentID;
+#ifndef GAME_DLL
+    static TriggerAreaGrid s_triggerAreaGrid;
+    static bool s_triggerAreaGridDirty;
+#endif
 
     PolygonTrigger *m_nextPolygonTrigger;
     Utf8String m_triggerName;
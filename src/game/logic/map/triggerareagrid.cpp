@@ -0,0 +1,235 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Uniform grid used to quickly find the polygon triggers that contain a point.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include "triggerareagrid.h"
+#include "polygontrigger.h"
+#include <algorithm>
+
+TriggerAreaGrid::TriggerAreaGrid() :
+    m_built(false), m_originX(0), m_originY(0), m_cellSize(1), m_cellCountX(0), m_cellCountY(0)
+{
+}
+
+void TriggerAreaGrid::Reset()
+{
+    m_built = false;
+    m_originX = 0;
+    m_originY = 0;
+    m_cellSize = 1;
+    m_cellCountX = 0;
+    m_cellCountY = 0;
+    m_cellStart.clear();
+    m_entries.clear();
+}
+
+void TriggerAreaGrid::Build(PolygonTrigger *first_trigger, int cell_size)
+{
+    Reset();
+    m_built = true;
+
+    bool have_bounds = false;
+    IRegion2D bounds;
+
+    for (PolygonTrigger *t = first_trigger; t != nullptr; t = t->Get_Next()) {
+        for (int i = 0; i < t->Get_Num_Points(); i++) {
+            const ICoord3D *pt = t->Get_Point(i);
+
+            if (!have_bounds) {
+                bounds.lo.x = bounds.hi.x = pt->x;
+                bounds.lo.y = bounds.hi.y = pt->y;
+                have_bounds = true;
+            } else {
+                bounds.lo.x = std::min(bounds.lo.x, pt->x);
+                bounds.lo.y = std::min(bounds.lo.y, pt->y);
+                bounds.hi.x = std::max(bounds.hi.x, pt->x);
+                bounds.hi.y = std::max(bounds.hi.y, pt->y);
+            }
+        }
+    }
+
+    if (!have_bounds) {
+        return;
+    }
+
+    // Point_In_Trigger rejects anything outside a trigger's bounds so the grid only has to cover their union.
+    m_originX = bounds.lo.x;
+    m_originY = bounds.lo.y;
+    m_cellSize = std::max(cell_size, 1);
+    long long width = (long long)bounds.hi.x - bounds.lo.x + 1;
+    long long height = (long long)bounds.hi.y - bounds.lo.y + 1;
+
+    for (;;) {
+        long long count_x = (width + m_cellSize - 1) / m_cellSize;
+        long long count_y = (height + m_cellSize - 1) / m_cellSize;
+
+        if (count_x * count_y <= MAX_CELLS) {
+            m_cellCountX = (int)count_x;
+            m_cellCountY = (int)count_y;
+            break;
+        }
+
+        m_cellSize *= 2;
+    }
+
+    std::vector<std::vector<CellEntry>> cells(m_cellCountX * m_cellCountY);
+
+    for (PolygonTrigger *t = first_trigger; t != nullptr; t = t->Get_Next()) {
+        Rasterize_Trigger(t, cells);
+    }
+
+    m_cellStart.resize(cells.size() + 1);
+    int total = 0;
+
+    for (size_t i = 0; i < cells.size(); i++) {
+        m_cellStart[i] = total;
+        total += (int)cells[i].size();
+    }
+
+    m_cellStart[cells.size()] = total;
+    m_entries.reserve(total);
+
+    for (size_t i = 0; i < cells.size(); i++) {
+        m_entries.insert(m_entries.end(), cells[i].begin(), cells[i].end());
+    }
+}
+
+const TriggerAreaGrid::CellEntry *TriggerAreaGrid::Get_Cell_Entries(const ICoord3D &point, int &count) const
+{
+    count = 0;
+
+    if (m_cellCountX == 0 || point.x < m_originX || point.y < m_originY) {
+        return nullptr;
+    }
+
+    int cell_x = (point.x - m_originX) / m_cellSize;
+    int cell_y = (point.y - m_originY) / m_cellSize;
+
+    if (cell_x >= m_cellCountX || cell_y >= m_cellCountY) {
+        return nullptr;
+    }
+
+    int cell = cell_y * m_cellCountX + cell_x;
+    count = m_cellStart[cell + 1] - m_cellStart[cell];
+
+    return count != 0 ? &m_entries[m_cellStart[cell]] : nullptr;
+}
+
+// Tests the segment against the cell grown by one unit on every side so that any integer point inside a cell that is not
+// touched is at least a full unit away from the edge, well clear of the float rounding in Point_In_Trigger.
+bool TriggerAreaGrid::Segment_Touches_Cell(const ICoord3D &p1, const ICoord3D &p2, int cell_x, int cell_y) const
+{
+    long long lo_x = (long long)m_originX + (long long)cell_x * m_cellSize - 1;
+    long long lo_y = (long long)m_originY + (long long)cell_y * m_cellSize - 1;
+    long long hi_x = lo_x + m_cellSize + 1;
+    long long hi_y = lo_y + m_cellSize + 1;
+
+    if (std::max(p1.x, p2.x) < lo_x || std::min(p1.x, p2.x) > hi_x || std::max(p1.y, p2.y) < lo_y
+        || std::min(p1.y, p2.y) > hi_y) {
+        return false;
+    }
+
+    long long dx = (long long)p2.x - p1.x;
+    long long dy = (long long)p2.y - p1.y;
+    long long corners[4][2] = { { lo_x, lo_y }, { hi_x, lo_y }, { hi_x, hi_y }, { lo_x, hi_y } };
+    bool positive = false;
+    bool negative = false;
+
+    for (int i = 0; i < 4; i++) {
+        long long cross = dx * (corners[i][1] - p1.y) - dy * (corners[i][0] - p1.x);
+
+        if (cross >= 0) {
+            positive = true;
+        }
+
+        if (cross <= 0) {
+            negative = true;
+        }
+    }
+
+    return positive && negative;
+}
+
+void TriggerAreaGrid::Rasterize_Trigger(PolygonTrigger *trigger, std::vector<std::vector<CellEntry>> &cells) const
+{
+    int num_points = trigger->Get_Num_Points();
+
+    if (num_points == 0) {
+        return;
+    }
+
+    IRegion2D bounds;
+    bounds.lo.x = bounds.hi.x = trigger->Get_Point(0)->x;
+    bounds.lo.y = bounds.hi.y = trigger->Get_Point(0)->y;
+
+    for (int i = 1; i < num_points; i++) {
+        const ICoord3D *pt = trigger->Get_Point(i);
+        bounds.lo.x = std::min(bounds.lo.x, pt->x);
+        bounds.lo.y = std::min(bounds.lo.y, pt->y);
+        bounds.hi.x = std::max(bounds.hi.x, pt->x);
+        bounds.hi.y = std::max(bounds.hi.y, pt->y);
+    }
+
+    int cell_lo_x = (bounds.lo.x - m_originX) / m_cellSize;
+    int cell_lo_y = (bounds.lo.y - m_originY) / m_cellSize;
+    int cell_hi_x = (bounds.hi.x - m_originX) / m_cellSize;
+    int cell_hi_y = (bounds.hi.y - m_originY) / m_cellSize;
+    int span_x = cell_hi_x - cell_lo_x + 1;
+    int span_y = cell_hi_y - cell_lo_y + 1;
+
+    // Lines and points have no interior, leave them entirely to the exact test.
+    std::vector<bool> edge_cells(span_x * span_y, num_points < 3);
+
+    if (num_points >= 3) {
+        for (int i = 0; i < num_points; i++) {
+            const ICoord3D &p1 = *trigger->Get_Point(i);
+            const ICoord3D &p2 = *trigger->Get_Point(i == num_points - 1 ? 0 : i + 1);
+            int lo_x = std::max((std::min(p1.x, p2.x) - 1 - m_originX) / m_cellSize, cell_lo_x);
+            int lo_y = std::max((std::min(p1.y, p2.y) - 1 - m_originY) / m_cellSize, cell_lo_y);
+            int hi_x = std::min((std::max(p1.x, p2.x) + 1 - m_originX) / m_cellSize, cell_hi_x);
+            int hi_y = std::min((std::max(p1.y, p2.y) + 1 - m_originY) / m_cellSize, cell_hi_y);
+
+            for (int y = lo_y; y <= hi_y; y++) {
+                for (int x = lo_x; x <= hi_x; x++) {
+                    int index = (y - cell_lo_y) * span_x + (x - cell_lo_x);
+
+                    if (!edge_cells[index] && Segment_Touches_Cell(p1, p2, x, y)) {
+                        edge_cells[index] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int y = cell_lo_y; y <= cell_hi_y; y++) {
+        for (int x = cell_lo_x; x <= cell_hi_x; x++) {
+            CellEntry entry;
+            entry.trigger = trigger;
+            entry.edge = edge_cells[(y - cell_lo_y) * span_x + (x - cell_lo_x)];
+
+            if (!entry.edge) {
+                // No edge comes near this cell so any point in it gives the answer for the whole cell.
+                ICoord3D pt;
+                pt.x = m_originX + x * m_cellSize;
+                pt.y = m_originY + y * m_cellSize;
+                pt.z = 0;
+
+                if (!trigger->Point_In_Trigger(pt)) {
+                    continue;
+                }
+            }
+
+            cells[y * m_cellCountX + x].push_back(entry);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Uniform grid used to quickly find the polygon triggers that contain a point.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#pragma once
+
+#include "always.h"
+#include "coord.h"
+#include <vector>
+
+class PolygonTrigger;
+
+// Every trigger is rasterised into the cells its bounds cover. Cells an edge passes near are flagged so that only those
+// need the exact PolygonTrigger::Point_In_Trigger test, cells that are entirely inside a trigger are answered directly.
+// Entries in each cell are kept in trigger list order so callers see triggers in the same order as a list walk.
+//
+// Scope: the grid is only used by Object::Set_Trigger_Area_Flags_For_Change_In_Position to find the areas an object
+// moved into, which replaces the point in polygon test against every trigger on the map. It deliberately keeps no
+// occupancy counts per trigger, player or KindOf. The conditions that would read them, such as
+// PLAYER_HAS_COMPARISON_UNIT_TYPE_IN_TRIGGER_AREA and PLAYER_HAS_COMPARISON_UNIT_KIND_IN_TRIGGER_AREA, are evaluated by
+// ScriptConditions::Evaluate_Condition which still calls into the original game, and the Team area checks only walk
+// team members reading their cached trigger flags. Counts kept up to date on every move, team change and KindOf change
+// would have no reader, so they are left until those evaluators are implemented here.
+class TriggerAreaGrid
+{
+public:
+    struct CellEntry
+    {
+        PolygonTrigger *trigger;
+        bool edge;
+    };
+
+    TriggerAreaGrid();
+
+    void Reset();
+    void Build(PolygonTrigger *first_trigger, int cell_size);
+
+    bool Is_Built() const { return m_built; }
+    const CellEntry *Get_Cell_Entries(const ICoord3D &point, int &count) const;
+
+private:
+    enum
+    {
+        MAX_CELLS = 1 << 20,
+    };
+
+    bool Segment_Touches_Cell(const ICoord3D &p1, const ICoord3D &p2, int cell_x, int cell_y) const;
+    void Rasterize_Trigger(PolygonTrigger *trigger, std::vector<std::vector<CellEntry>> &cells) const;
+
+    bool m_built;
+    int m_originX;
+    int m_originY;
+    int m_cellSize;
+    int m_cellCountX;
+    int m_cellCountY;
+    std::vector<int> m_cellStart; // Index of the first entry for each cell, one extra element marks the end.
+    std::vector<CellEntry> m_entries;
+};
@@ -22,6 +22,7 @@
 #include "object.h"
 #include "partitionmanager.h"
 #include "physicsupdate.h"
+#include "scriptengine.h"
 #include "terrainlogic.h"
 #include <algorithm>
 
@@ -2164,6 +2165,11 @@ void LocomotorSet::Add_Locomotor(const LocomotorTemplate *lt)
         m_locomotors.push_back(l);
         m_validLocomotorSurfaces |= l->Get_Legal_Surfaces();
 
+        // Team area conditions filter members by their valid surfaces.
+        if (g_theScriptEngine != nullptr) {
+            g_theScriptEngine->Notify_Of_Object_State_Change();
+        }
+
         if (l->Get_Downhill_Only()) {
             m_downhillOnly = true;
         } else if (m_downhillOnly) {
@@ -2183,6 +2189,10 @@ void LocomotorSet::Clear()
 
     m_locomotors.clear();
     m_validLocomotorSurfaces = 0;
+
+    if (g_theScriptEngine != nullptr) {
+        g_theScriptEngine->Notify_Of_Object_State_Change();
+    }
     m_downhillOnly = false;
 }
 
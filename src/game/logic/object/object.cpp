@@ -2430,6 +2430,9 @@ void Object::Set_Trigger_Area_Flags_For_Change_In_Position()
                     m_triggerInfo[i].inside = false;
                     m_triggerInfo[i].exited = true;
                     m_enteredOrExited = frame;
+                    if (g_theScriptEngine != nullptr) {
+                        g_theScriptEngine->Notify_Of_Trigger_Area_Change();
+                    }
 
                     if (m_team != nullptr) {
                         m_team->Set_Entered_Exited();
@@ -2441,7 +2444,17 @@ void Object::Set_Trigger_Area_Flags_For_Change_In_Position()
 
             m_iPos = ipos;
 
+#ifndef GAME_DLL
+            // Only the triggers rasterised into the cell we are now in can contain us, in the same order as the list.
+            int entry_count;
+            const TriggerAreaGrid::CellEntry *entries =
+                PolygonTrigger::Get_Trigger_Area_Grid().Get_Cell_Entries(m_iPos, entry_count);
+
+            for (int j = 0; j < entry_count; j++) {
+                PolygonTrigger *t = entries[j].trigger;
+#else
             for (PolygonTrigger *t = PolygonTrigger::Get_First_Polygon_Trigger(); t != nullptr; t = t->Get_Next()) {
+#endif
                 bool trigger_found = false;
 
                 for (int i = 0; i < m_numTriggerAreasActive; i++) {
@@ -2451,7 +2464,11 @@ void Object::Set_Trigger_Area_Flags_For_Change_In_Position()
                     }
                 }
 
+#ifndef GAME_DLL
+                if (!trigger_found && (!entries[j].edge || t->Point_In_Trigger(m_iPos))) {
+#else
                 if (!trigger_found && t->Point_In_Trigger(m_iPos)) {
+#endif
                     if (m_numTriggerAreasActive >= 5) {
                         static bool didWarn;
 
@@ -2465,6 +2482,9 @@ void Object::Set_Trigger_Area_Flags_For_Change_In_Position()
                         m_triggerInfo[m_numTriggerAreasActive].exited = false;
                         m_triggerInfo[m_numTriggerAreasActive].polygon_trigger = t;
                         m_enteredOrExited = frame;
+                        if (g_theScriptEngine != nullptr) {
+                            g_theScriptEngine->Notify_Of_Trigger_Area_Change();
+                        }
 
                         if (m_team != nullptr) {
                             m_team->Set_Entered_Exited();
@@ -2482,9 +2502,16 @@ void Object::Set_Trigger_Area_Flags_For_Change_In_Position()
 void Object::Update_Trigger_Area_Flags()
 {
     int count = 0;
+    bool changed = false;
 
     for (int i = 0; i < m_numTriggerAreasActive; i++) {
         if (m_triggerInfo[count].inside) {
+            if (m_triggerInfo[count].entered || m_triggerInfo[count].exited
+                || m_triggerInfo[count].inside != m_triggerInfo[i].inside
+                || m_triggerInfo[count].polygon_trigger != m_triggerInfo[i].polygon_trigger) {
+                changed = true;
+            }
+
             m_triggerInfo[count].entered = false;
             m_triggerInfo[count].exited = false;
             m_triggerInfo[count].inside = m_triggerInfo[i].inside;
@@ -2493,6 +2520,11 @@ void Object::Update_Trigger_Area_Flags()
         }
     }
 
+    // Area conditions only read these flags, so they stay cached when clearing them changed nothing.
+    if ((changed || count != m_numTriggerAreasActive) && g_theScriptEngine != nullptr) {
+        g_theScriptEngine->Notify_Of_Trigger_Area_Change();
+    }
+
     m_numTriggerAreasActive = count;
 }
 
@@ -2500,6 +2532,9 @@ void Object::Set_Or_Restore_Team(Team *team, bool b)
 {
     if (m_team != team) {
         Team *old_team = m_team;
+        if (g_theScriptEngine != nullptr) {
+            g_theScriptEngine->Notify_Of_Object_State_Change();
+        }
 
         if (m_team != nullptr && m_team->Is_In_List_Team_Member_List(this)) {
             m_team->Remove_From_Team_Member_List(this);
@@ -3882,6 +3917,10 @@ void Object::Set_Effectively_Dead(bool dead)
         m_privateStatus &= ~STATUS_EFFECTIVELY_DEAD;
     }
 
+    if (g_theScriptEngine != nullptr) {
+        g_theScriptEngine->Notify_Of_Object_State_Change();
+    }
+
     if (dead) {
         if (m_radarData != nullptr) {
             g_theRadar->Remove_Object(this);
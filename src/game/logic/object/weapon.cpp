@@ -40,6 +40,9 @@
 #include "terrainlogic.h"
 #include "thingfactory.h"
 #include "weaponset.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 
 void Do_FX_Pos(FXList const *list,
     const Coord3D *primary,
@@ -136,7 +139,14 @@ void WeaponStore::Set_Delayed_Damage(const WeaponTemplate *weapon,
     info.m_delaySourceID = source_id;
     info.m_delayIntendedVictimID = victim_id;
     info.m_bonus = bonus;
+#ifdef GAME_DLL
     m_weaponDDI.push_back(info);
+#else
+    DelayedDamageEntry entry;
+    entry.sequence = m_delayedDamageSequence++;
+    entry.info = info;
+    m_delayedDamage[which_frame].push_back(entry);
+#endif
 }
 
 void WeaponStore::Parse_Weapon_Template(INI *ini, void *formal, void *store, const void *user_data)
@@ -152,6 +162,13 @@ Weapon *WeaponStore::Allocate_New_Weapon(const WeaponTemplate *tmpl, WeaponSlotT
     return new Weapon(tmpl, wslot);
 }
 
+WeaponStore::WeaponStore()
+{
+#ifndef GAME_DLL
+    m_delayedDamageSequence = 0;
+#endif
+}
+
 WeaponStore::~WeaponStore()
 {
     Delete_All_Delayed_Damage();
@@ -165,6 +182,9 @@ WeaponStore::~WeaponStore()
     }
 
     m_weaponTemplateVector.clear();
+#ifndef GAME_DLL
+    m_weaponTemplatesByKey.clear();
+#endif
 }
 
 void WeaponStore::Handle_Projectile_Detonation(const WeaponTemplate *tmplate,
@@ -192,6 +212,13 @@ void WeaponStore::Create_And_Fire_Temp_Weapon(
 
 WeaponTemplate *WeaponStore::Find_Weapon_Template_Private(NameKeyType key) const
 {
+#ifndef GAME_DLL
+    if (key >= 0 && key < (NameKeyType)m_weaponTemplatesByKey.size()) {
+        return m_weaponTemplatesByKey[key];
+    }
+
+    return nullptr;
+#else
     for (unsigned int i = 0; i < m_weaponTemplateVector.size(); i++) {
         WeaponTemplate *tmplate = m_weaponTemplateVector[i];
 
@@ -201,6 +228,7 @@ WeaponTemplate *WeaponStore::Find_Weapon_Template_Private(NameKeyType key) const
     }
 
     return nullptr;
+#endif
 }
 
 WeaponTemplate *WeaponStore::New_Weapon_Template(Utf8String name)
@@ -212,6 +240,16 @@ WeaponTemplate *WeaponStore::New_Weapon_Template(Utf8String name)
         tmplate->m_name = name;
         tmplate->m_nameKey = g_theNameKeyGenerator->Name_To_Key(name.Str());
         m_weaponTemplateVector.push_back(tmplate);
+#ifndef GAME_DLL
+        if (tmplate->m_nameKey >= (NameKeyType)m_weaponTemplatesByKey.size()) {
+            m_weaponTemplatesByKey.resize(tmplate->m_nameKey + 1, nullptr);
+        }
+
+        // Keep the first template with a key like the linear search over the vector did.
+        if (m_weaponTemplatesByKey[tmplate->m_nameKey] == nullptr) {
+            m_weaponTemplatesByKey[tmplate->m_nameKey] = tmplate;
+        }
+#endif
         return tmplate;
     }
 }
@@ -230,6 +268,7 @@ WeaponTemplate *WeaponStore::New_Override(WeaponTemplate *tmplate)
 
 void WeaponStore::Update()
 {
+#ifdef GAME_DLL
     for (auto i = m_weaponDDI.begin(); i != m_weaponDDI.end();) {
         if (g_theGameLogic->Get_Frame() >= i->m_delayDamageFrame) {
             i->m_delayedWeapon->Deal_Damage_Internal(
@@ -239,11 +278,51 @@ void WeaponStore::Update()
             i++;
         }
     }
+#else
+    // Anything queued while dealing the damage is due on a later frame, so pulling out everything due first and then
+    // dealing it in the order it was queued matches dealing it while walking a single list.
+    auto first = m_delayedDamage.begin();
+    auto last = m_delayedDamage.upper_bound(g_theGameLogic->Get_Frame());
+
+    if (first == last) {
+        return;
+    }
+
+    m_dueDamage.clear();
+
+    for (auto i = first; i != last; i++) {
+        m_dueDamage.insert(m_dueDamage.end(), i->second.begin(), i->second.end());
+    }
+
+    if (std::next(first) != last) {
+        // Only happens if updates were skipped, buckets from different frames have to interleave in queue order.
+        std::sort(m_dueDamage.begin(), m_dueDamage.end(), [](const DelayedDamageEntry &a, const DelayedDamageEntry &b) {
+            return a.sequence < b.sequence;
+        });
+    }
+
+    m_delayedDamage.erase(first, last);
+
+    if (m_delayedDamage.empty()) {
+        m_delayedDamageSequence = 0;
+    }
+
+    for (const DelayedDamageEntry &entry : m_dueDamage) {
+        const WeaponDelayedDamageInfo &info = entry.info;
+        info.m_delayedWeapon->Deal_Damage_Internal(
+            info.m_delaySourceID, info.m_delayIntendedVictimID, &info.m_delayDamagePos, info.m_bonus, false);
+    }
+#endif
 }
 
 void WeaponStore::Delete_All_Delayed_Damage()
 {
+#ifdef GAME_DLL
     m_weaponDDI.clear();
+#else
+    m_delayedDamage.clear();
+    m_delayedDamageSequence = 0;
+#endif
 }
 
 void WeaponStore::Reset_Weapon_Templates()
@@ -1891,7 +1970,11 @@ WeaponTemplate::~WeaponTemplate()
 
 void WeaponTemplate::Reset()
 {
+#ifdef GAME_DLL
     m_historicDamage.clear();
+#else
+    m_historicDamage.Clear();
+#endif
 }
 
 void WeaponTemplate::Parse_Weapon_Bonus_Set(INI *ini, void *formal, void *store, const void *user_data)
@@ -2050,9 +2133,13 @@ void WeaponTemplate::Trim_Old_Historic_Damage() const
 {
     unsigned int frame = g_theGameLogic->Get_Frame() - g_theWriteableGlobalData->m_historicDamageLimit;
 
+#ifdef GAME_DLL
     while (m_historicDamage.size() != 0 && m_historicDamage.front().frame <= frame) {
         m_historicDamage.pop_front();
     }
+#else
+    m_historicDamage.Trim(frame);
+#endif
 }
 
 bool WeaponTemplate::Should_Projectile_Collide_With(
@@ -2597,6 +2684,151 @@ bool Is_2D_Dist_Squared_Less_Than(const Coord3D *pos, const Coord3D *pos2, float
     return GameMath::Square(pos->x - pos2->x) + GameMath::Square(pos->y - pos2->y) <= dist_sqr;
 }
 
+#ifndef GAME_DLL
+HistoricDamageBuffer::HistoricDamageBuffer() : m_first(0), m_end(0), m_cellSize(1.0f), m_cellEntries(0) {}
+
+void HistoricDamageBuffer::Clear()
+{
+    m_first = 0;
+    m_end = 0;
+    m_cells.clear();
+    m_cellEntries = 0;
+}
+
+void HistoricDamageBuffer::Add(const HistoricWeaponDamageInfo &info, float cell_size)
+{
+    if (cell_size <= 0.0f) {
+        cell_size = 1.0f;
+    }
+
+    if (m_ring.empty()) {
+        // Most weapons have no historic bonus, so the ring is only allocated by the first hit.
+        m_ring.resize(INITIAL_CAPACITY);
+    } else if (m_end - m_first == m_ring.size()) {
+        Grow();
+    }
+
+    m_ring[Get_Slot(m_end)] = info;
+    m_end++;
+
+    if (cell_size != m_cellSize || m_cellEntries > 2 * (m_end - m_first) + m_ring.size() / 16) {
+        // Cells only drop forgotten hits when they are added to, so now and then refile the ones still remembered.
+        m_cellSize = cell_size;
+        Rebuild_Cells();
+    } else {
+        std::vector<unsigned int> &cell =
+            m_cells[Get_Cell_Key(Get_Cell_Coord(info.location.x), Get_Cell_Coord(info.location.y))];
+        size_t forgotten = 0;
+
+        while (forgotten < cell.size() && cell[forgotten] - m_first >= m_end - m_first) {
+            forgotten++;
+        }
+
+        cell.erase(cell.begin(), cell.begin() + forgotten);
+        cell.push_back(m_end - 1);
+        m_cellEntries = m_cellEntries + 1 - forgotten;
+    }
+}
+
+/**
+ * Forgets the hits from the given frame or before, hits are always added in frame order.
+ */
+void HistoricDamageBuffer::Trim(unsigned int frame)
+{
+    while (m_first != m_end && m_ring[Get_Slot(m_first)].frame <= frame) {
+        m_first++;
+    }
+
+    if (m_first == m_end) {
+        Clear();
+    }
+}
+
+/**
+ * Counts the remembered hits since the given frame within radius of pos in 2D.
+ */
+int HistoricDamageBuffer::Count_Near(const Coord3D &pos, float radius, unsigned int since_frame) const
+{
+    if (m_first == m_end) {
+        return 0;
+    }
+
+    float radius_sqr = radius * radius;
+    int lo_x = Get_Cell_Coord(pos.x - radius);
+    int lo_y = Get_Cell_Coord(pos.y - radius);
+    int hi_x = Get_Cell_Coord(pos.x + radius);
+    int hi_y = Get_Cell_Coord(pos.y + radius);
+    int count = 0;
+
+    if ((int64_t)(hi_x - lo_x + 1) * (hi_y - lo_y + 1) > (int64_t)(m_end - m_first)) {
+        for (unsigned int i = m_first; i != m_end; i++) {
+            const HistoricWeaponDamageInfo &info = m_ring[Get_Slot(i)];
+
+            if (info.frame >= since_frame && Is_2D_Dist_Squared_Less_Than(&pos, &info.location, radius_sqr)) {
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    for (int y = lo_y; y <= hi_y; y++) {
+        for (int x = lo_x; x <= hi_x; x++) {
+            auto cell = m_cells.find(Get_Cell_Key(x, y));
+
+            if (cell == m_cells.end()) {
+                continue;
+            }
+
+            for (auto it = cell->second.begin(); it != cell->second.end(); it++) {
+                if (*it - m_first >= m_end - m_first) {
+                    continue;
+                }
+
+                const HistoricWeaponDamageInfo &info = m_ring[Get_Slot(*it)];
+
+                if (info.frame >= since_frame && Is_2D_Dist_Squared_Less_Than(&pos, &info.location, radius_sqr)) {
+                    count++;
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+void HistoricDamageBuffer::Rebuild_Cells()
+{
+    m_cells.clear();
+    m_cellEntries = 0;
+
+    for (unsigned int i = m_first; i != m_end; i++) {
+        const HistoricWeaponDamageInfo &info = m_ring[Get_Slot(i)];
+        m_cells[Get_Cell_Key(Get_Cell_Coord(info.location.x), Get_Cell_Coord(info.location.y))].push_back(i);
+        m_cellEntries++;
+    }
+}
+
+/**
+ * Doubles the ring, hits keep their running numbers so the cells still find them.
+ */
+void HistoricDamageBuffer::Grow()
+{
+    std::vector<HistoricWeaponDamageInfo> ring(m_ring.size() * 2);
+
+    for (unsigned int i = m_first; i != m_end; i++) {
+        ring[i & (ring.size() - 1)] = m_ring[Get_Slot(i)];
+    }
+
+    m_ring.swap(ring);
+}
+
+int HistoricDamageBuffer::Get_Cell_Coord(float value) const
+{
+    return (int)std::floor(value / m_cellSize);
+}
+#endif
+
 void WeaponTemplate::Deal_Damage_Internal(ObjectID source_id,
     ObjectID victim_id,
     const Coord3D *pos,
@@ -2613,6 +2845,7 @@ void WeaponTemplate::Deal_Damage_Internal(ObjectID source_id,
             unsigned int frame = g_theGameLogic->Get_Frame();
             unsigned int frame2 = frame - m_historicBonusTime;
 
+#ifdef GAME_DLL
             for (auto it = m_historicDamage.begin(); it != m_historicDamage.end(); it++) {
                 if (it->frame >= frame2) {
                     if (Is_2D_Dist_Squared_Less_Than(pos, &it->location, radius_sqr)) {
@@ -2620,13 +2853,24 @@ void WeaponTemplate::Deal_Damage_Internal(ObjectID source_id,
                     }
                 }
             }
+#else
+            count = m_historicDamage.Count_Near(*pos, m_historicBonusRadius, frame2);
+#endif
 
             if (count < m_historicBonusCount - 1) {
                 HistoricWeaponDamageInfo info(frame, *pos);
+#ifdef GAME_DLL
                 m_historicDamage.push_back(info);
+#else
+                m_historicDamage.Add(info, m_historicBonusRadius);
+#endif
             } else {
                 g_theWeaponStore->Create_And_Fire_Temp_Weapon(m_historicBonusWeapon, source, pos);
+#ifdef GAME_DLL
                 m_historicDamage.clear();
+#else
+                m_historicDamage.Clear();
+#endif
             }
         }
 
@@ -25,8 +25,13 @@
 #include "snapshot.h"
 #include "weaponset.h"
 #include <list>
+#include <map>
 #include <vector>
 
+#ifndef GAME_DLL
+#include <unordered_map>
+#endif
+
 class FXList;
 class INI;
 class Object;
@@ -183,9 +188,46 @@ struct HistoricWeaponDamageInfo
 {
     unsigned int frame;
     Coord3D location;
+    HistoricWeaponDamageInfo() : frame(0) { location.Zero(); }
     HistoricWeaponDamageInfo(unsigned int f, const Coord3D &loc) : frame(f), location(loc) {}
 };
 
+#ifndef GAME_DLL
+// Hits remembered for a weapon's historic bonus, oldest first. They live in a ring buffer and each is also filed in a
+// grid with cells the size of the bonus radius so that counting the hits around a position only looks at the
+// neighbouring cells. Like the list it replaces the buffer has no limit, a hit added to a full ring doubles it.
+class HistoricDamageBuffer
+{
+public:
+    enum
+    {
+        INITIAL_CAPACITY = 64, // Power of two so a hit's slot is its running number masked.
+    };
+
+    HistoricDamageBuffer();
+
+    void Clear();
+    void Add(const HistoricWeaponDamageInfo &info, float cell_size);
+    void Trim(unsigned int frame);
+    int Count_Near(const Coord3D &pos, float radius, unsigned int since_frame) const;
+    int Get_Count() const { return (int)(m_end - m_first); }
+
+private:
+    size_t Get_Slot(unsigned int number) const { return number & (m_ring.size() - 1); }
+    int64_t Get_Cell_Key(int x, int y) const { return (int64_t)(((uint64_t)(uint32_t)x << 32) | (uint32_t)y); }
+    int Get_Cell_Coord(float value) const;
+    void Rebuild_Cells();
+    void Grow();
+
+    std::vector<HistoricWeaponDamageInfo> m_ring;
+    unsigned int m_first; // Running number of the oldest hit still remembered.
+    unsigned int m_end; // Running number the next hit will get.
+    float m_cellSize;
+    std::unordered_map<int64_t, std::vector<unsigned int>> m_cells;
+    size_t m_cellEntries;
+};
+#endif
+
 class WeaponTemplate : public MemoryPoolObject
 {
     IMPLEMENT_POOL(WeaponTemplate);
@@ -375,7 +417,11 @@ private:
     ObjectStatusTypes m_damageStatusType;
     unsigned int m_suspendFXDelay;
     bool m_missileCallsOnDie;
+#ifdef GAME_DLL
     mutable std::list<HistoricWeaponDamageInfo> m_historicDamage;
+#else
+    mutable HistoricDamageBuffer m_historicDamage;
+#endif
 
     static FieldParse s_fieldParseTable[];
     friend class WeaponStore;
@@ -580,7 +626,7 @@ public:
     WeaponStore *Hook_Ctor() { return new (this) WeaponStore(); }
 #endif
 
-    WeaponStore() {}
+    WeaponStore();
 
     virtual ~WeaponStore() override;
     virtual void Init() override {}
@@ -614,8 +660,26 @@ public:
     static void Parse_Weapon_Template_Definition(INI *ini);
 
 private:
+#ifndef GAME_DLL
+    struct DelayedDamageEntry
+    {
+        unsigned int sequence; // Order the damage was queued in.
+        WeaponDelayedDamageInfo info;
+    };
+#endif
+
     std::vector<WeaponTemplate *> m_weaponTemplateVector;
+#ifndef GAME_DLL
+    std::vector<WeaponTemplate *> m_weaponTemplatesByKey; // Same templates as above indexed by name key.
+#endif
+#ifdef GAME_DLL
     std::list<WeaponDelayedDamageInfo> m_weaponDDI;
+#else
+    // Delayed damage bucketed on the frame it is due, so each update only touches what is due.
+    std::map<unsigned int, std::vector<DelayedDamageEntry>> m_delayedDamage;
+    unsigned int m_delayedDamageSequence;
+    std::vector<DelayedDamageEntry> m_dueDamage; // Scratch for the entries due this frame.
+#endif
 };
 
 #ifdef GAME_DLL
@@ -25,12 +25,18 @@ Condition::Condition() :
     m_frame(0)
 {
     memset(m_params, 0, sizeof(m_params));
+#ifndef GAME_DLL
+    memset(&m_cacheEntry, 0, sizeof(m_cacheEntry));
+#endif
 }
 
 Condition::Condition(ConditionType type) :
     m_conditionType(type), m_numParams(0), m_nextAndCondition(nullptr), m_hasWarnings(false), m_customData(0), m_frame(0)
 {
     memset(m_params, 0, sizeof(m_params));
+#ifndef GAME_DLL
+    memset(&m_cacheEntry, 0, sizeof(m_cacheEntry));
+#endif
     Set_Condition_Type(m_conditionType);
 }
 
@@ -131,6 +137,9 @@ void Condition::Set_Condition_Type(ConditionType type)
     }
 
     m_conditionType = type;
+#ifndef GAME_DLL
+    m_cacheEntry.valid = false;
+#endif
     ConditionTemplate *condition_template = g_theScriptEngine->Get_Condition_Template(m_conditionType);
     m_numParams = condition_template->Get_Num_Parameters();
 
@@ -139,6 +148,44 @@ void Condition::Set_Condition_Type(ConditionType type)
     }
 }
 
+/**
+ * @brief Returns the set of ConditionInput flags a condition type depends on.
+ *
+ * Anything that reads per frame state such as attack or enter/exit events, audio and video completion or uses the
+ * conditions custom data and frame is left as always dirty. So are the player unit comparisons in trigger areas, as
+ * their evaluators are not ours to check for what else they read.
+ */
+unsigned int Condition::Get_Condition_Inputs(ConditionType type)
+{
+    switch (type) {
+        case CONDITION_FALSE:
+        case CONDITION_TRUE:
+            return INPUT_NONE;
+        case COUNTER:
+        case TIMER_EXPIRED:
+            return INPUT_COUNTER;
+        case FLAG:
+            return INPUT_FLAG;
+        case NAMED_DESTROYED:
+        case NAMED_NOT_DESTROYED:
+        case NAMED_DYING:
+        case NAMED_TOTALLY_DEAD:
+            return INPUT_NAMED_UNIT;
+        case TEAM_DESTROYED:
+        case TEAM_HAS_UNITS:
+            return INPUT_TEAM;
+        case NAMED_INSIDE_AREA:
+        case NAMED_OUTSIDE_AREA:
+            return INPUT_NAMED_UNIT | INPUT_AREA;
+        case TEAM_INSIDE_AREA_PARTIALLY:
+        case TEAM_INSIDE_AREA_ENTIRELY:
+        case TEAM_OUTSIDE_AREA_ENTIRELY:
+            return INPUT_TEAM | INPUT_AREA;
+        default:
+            return INPUT_ALWAYS_DIRTY;
+    }
+}
+
 /**
  * @brief Parses a condition from a datachunk stream.
  *
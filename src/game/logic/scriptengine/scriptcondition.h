@@ -19,6 +19,26 @@
 #include "mempoolobj.h"
 #include "scriptparam.h"
 
+class Object;
+class Player;
+class Team;
+
+#ifndef GAME_DLL
+// Last result of a condition evaluation along with the context it was evaluated in. The serial is the script engine's
+// dirty serial at the time of evaluation, see ScriptEngine::Evaluate_Condition.
+struct ConditionCacheEntry
+{
+    bool valid;
+    bool result;
+    unsigned int serial;
+    const Team *condition_team;
+    const Team *calling_team;
+    const Player *player;
+    const Object *condition_object;
+    const Object *calling_object;
+};
+#endif
+
 class Condition : public MemoryPoolObject
 {
     IMPLEMENT_POOL(Condition);
@@ -144,6 +164,18 @@ public:
         CONDITION_COUNT,
     };
 
+    // Inputs a condition type reads, used to decide when a previously evaluated result goes stale.
+    enum ConditionInput
+    {
+        INPUT_NONE = 0,
+        INPUT_COUNTER = 1 << 0, // Counter or timer referenced by parameter 0.
+        INPUT_FLAG = 1 << 1, // Flag referenced by parameter 0 and UI interaction hooks.
+        INPUT_NAMED_UNIT = 1 << 2, // Named object cache and object life state.
+        INPUT_TEAM = 1 << 3, // Team instances and their membership.
+        INPUT_AREA = 1 << 4, // Occupancy of a polygon trigger.
+        INPUT_ALWAYS_DIRTY = 1 << 5, // Unclassified, must be evaluated every time.
+    };
+
 protected:
     virtual ~Condition() override;
 
@@ -177,6 +209,11 @@ public:
     void Set_Custom_Data(int data) { m_customData = data; }
     void Set_Frame(int frame) { m_frame = frame; }
 
+#ifndef GAME_DLL
+    ConditionCacheEntry &Get_Cache_Entry() { return m_cacheEntry; }
+#endif
+
+    static unsigned int Get_Condition_Inputs(ConditionType type);
     static bool Parse_Condition_Data_Chunk(DataChunkInput &input, DataChunkInfo *info, void *data);
     static void Write_Condition_Data_Chunk(DataChunkOutput &output, Condition *condition);
 
@@ -188,6 +225,9 @@ private:
     int m_hasWarnings;
     int m_customData;
     int m_frame;
+#ifndef GAME_DLL
+    ConditionCacheEntry m_cacheEntry;
+#endif
 };
 
 class OrCondition : public MemoryPoolObject
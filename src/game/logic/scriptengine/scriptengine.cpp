@@ -180,6 +180,11 @@ ScriptEngine::ScriptEngine() :
     s_currentFrame = 0;
     s_lastFrame = s_currentFrame;
     Set_Global_Difficulty(DIFFICULTY_NORMAL);
+#ifndef GAME_DLL
+    m_conditionCacheMode = CONDITION_CACHE_ON;
+    m_conditionSerial = 0;
+    Invalidate_Condition_Cache();
+#endif
 }
 
 ScriptEngine::~ScriptEngine()
@@ -4931,6 +4936,7 @@ void ScriptEngine::Reset()
     m_unkInt1 = 0;
     m_objectCreationDestructionFrame = 0;
     m_hasShownMPLocalDefeatWindow = 0;
+    Invalidate_Condition_Cache();
 
     for (int i = 0; i < MAX_COUNTERS; i++) {
         m_counters[i].value = 0;
@@ -5058,6 +5064,7 @@ void ScriptEngine::Reset()
 
 void ScriptEngine::New_Map()
 {
+    Invalidate_Condition_Cache();
     m_numCounters = 1;
 
     for (int i = 0; i < MAX_COUNTERS; i++) {
@@ -5170,6 +5177,7 @@ void ScriptEngine::Update()
                 if (m_counters[i].is_countdown_timer) {
                     if (m_counters[i].value >= 0) {
                         m_counters[i].value--;
+                        Mark_Counter_Dirty(i);
                     }
                 }
             }
@@ -5192,7 +5200,12 @@ void ScriptEngine::Update()
             }
 
             g_thePlayerList->Update_Team_States();
-            m_uiInteraction.clear();
+
+            if (!m_uiInteraction.empty()) {
+                m_uiInteraction.clear();
+                Mark_UI_Interaction_Dirty();
+            }
+
             Evaluate_And_Progress_All_Sequential_Scripts();
             s_currentFrame++;
 
@@ -5345,6 +5358,7 @@ void ScriptEngine::Clear_Flag(const Utf8String &flag)
         for (int flag_idx = 1; flag_idx < m_numFlags; flag_idx++) {
             if (str == m_flags[flag_idx].name) {
                 m_flags[flag_idx].value = false;
+                Mark_Flag_Dirty(flag_idx);
             }
         }
     }
@@ -5886,6 +5900,7 @@ void ScriptEngine::Set_Counter(ScriptAction *action)
     }
 
     m_counters[counter].value = action->Get_Parameter(1)->Get_Int();
+    Mark_Counter_Dirty(counter);
 }
 
 void ScriptEngine::Set_Fade(ScriptAction *action)
@@ -5960,6 +5975,7 @@ void ScriptEngine::Add_Counter(ScriptAction *action)
     }
 
     m_counters[counter].value += value;
+    Mark_Counter_Dirty(counter);
 }
 
 void ScriptEngine::Sub_Counter(ScriptAction *action)
@@ -5974,6 +5990,7 @@ void ScriptEngine::Sub_Counter(ScriptAction *action)
     }
 
     m_counters[counter].value -= value;
+    Mark_Counter_Dirty(counter);
 }
 
 bool ScriptEngine::Evaluate_Flag(Condition *condition)
@@ -6012,6 +6029,7 @@ void ScriptEngine::Set_Flag(ScriptAction *action)
     }
 
     m_flags[flag].value = action->Get_Parameter(1)->Get_Int() != 0;
+    Mark_Flag_Dirty(flag);
 }
 
 AttackPriorityInfo *ScriptEngine::Find_Attack_Info(const Utf8String &name, bool add_if_not_found)
@@ -6202,6 +6220,7 @@ void ScriptEngine::Set_Timer(ScriptAction *action, bool millisecond_timer, bool
     }
 
     m_counters[counter].is_countdown_timer = true;
+    Mark_Counter_Dirty(counter);
 }
 
 void ScriptEngine::Pause_Timer(ScriptAction *action)
@@ -6215,6 +6234,7 @@ void ScriptEngine::Pause_Timer(ScriptAction *action)
     }
 
     m_counters[counter].is_countdown_timer = false;
+    Mark_Counter_Dirty(counter);
 }
 
 void ScriptEngine::Restart_Timer(ScriptAction *action)
@@ -6229,6 +6249,7 @@ void ScriptEngine::Restart_Timer(ScriptAction *action)
 
     if (m_counters[counter].value > 0) {
         m_counters[counter].is_countdown_timer = true;
+        Mark_Counter_Dirty(counter);
     }
 }
 
@@ -6259,6 +6280,8 @@ void ScriptEngine::Adjust_Timer(ScriptAction *action, bool millisecond_timer, bo
 
         m_counters[counter].value += value;
     }
+
+    Mark_Counter_Dirty(counter);
 }
 
 void ScriptEngine::Enable_Script(ScriptAction *action)
@@ -6485,7 +6508,112 @@ void ScriptEngine::Execute_Script(Script *script)
     }
 }
 
+/**
+ * Evaluates a condition, reusing the result of the last evaluation if none of the inputs the condition type declares
+ * through Condition::Get_Condition_Inputs have been dirtied since and it is evaluated in the same context.
+ */
 bool ScriptEngine::Evaluate_Condition(Condition *condition)
+{
+#ifndef GAME_DLL
+    if (m_conditionCacheMode != CONDITION_CACHE_OFF) {
+        if (Is_Condition_Cache_Valid(condition)) {
+            bool cached = condition->Get_Cache_Entry().result;
+
+            if (m_conditionCacheMode == CONDITION_CACHE_VERIFY) {
+                bool ret = Evaluate_Condition_Uncached(condition);
+                captainslog_relassert(ret == cached,
+                    0,
+                    "Cached result for condition '%s' is stale.",
+                    Get_Condition_Template(condition->Get_Condition_Type())->m_internalName.Str());
+                return ret;
+            }
+
+            return cached;
+        }
+
+        // Take the serial before evaluating so anything the evaluation itself dirties invalidates the result.
+        unsigned int serial = m_conditionSerial;
+        bool ret = Evaluate_Condition_Uncached(condition);
+        Cache_Condition_Result(condition, serial, ret);
+
+        return ret;
+    }
+#endif
+
+    return Evaluate_Condition_Uncached(condition);
+}
+
+bool ScriptEngine::Is_Condition_Cache_Valid(Condition *condition)
+{
+#ifndef GAME_DLL
+    const ConditionCacheEntry &entry = condition->Get_Cache_Entry();
+
+    if (!entry.valid || m_conditionInvalidateSerial > entry.serial) {
+        return false;
+    }
+
+    unsigned int inputs = Condition::Get_Condition_Inputs(condition->Get_Condition_Type());
+
+    if ((inputs & Condition::INPUT_ALWAYS_DIRTY) != 0) {
+        return false;
+    }
+
+    if ((inputs & Condition::INPUT_AREA) != 0 && m_areaSerial > entry.serial) {
+        return false;
+    }
+
+    if ((inputs & Condition::INPUT_COUNTER) != 0) {
+        int counter = condition->Get_Parameter(0)->Get_Int();
+
+        if (counter <= 0 || counter >= MAX_COUNTERS || m_counterSerials[counter] > entry.serial) {
+            return false;
+        }
+    }
+
+    if ((inputs & Condition::INPUT_FLAG) != 0) {
+        int flag = condition->Get_Parameter(0)->Get_Int();
+
+        if (flag <= 0 || flag >= MAX_FLAGS || m_flagSerials[flag] > entry.serial
+            || m_uiInteractionSerial > entry.serial) {
+            return false;
+        }
+    }
+
+    if ((inputs & (Condition::INPUT_NAMED_UNIT | Condition::INPUT_TEAM | Condition::INPUT_AREA)) != 0) {
+        if (m_objectStateSerial > entry.serial) {
+            return false;
+        }
+
+        // Parameters such as "<This Team>" and "<This Object>" resolve against the current context.
+        if (entry.condition_team != m_conditionTeam || entry.calling_team != m_callingTeam
+            || entry.player != m_currentPlayer || entry.condition_object != m_conditionObject
+            || entry.calling_object != m_callingObject) {
+            return false;
+        }
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ScriptEngine::Cache_Condition_Result(Condition *condition, unsigned int serial, bool result)
+{
+#ifndef GAME_DLL
+    ConditionCacheEntry &entry = condition->Get_Cache_Entry();
+    entry.valid = true;
+    entry.result = result;
+    entry.serial = serial;
+    entry.condition_team = m_conditionTeam;
+    entry.calling_team = m_callingTeam;
+    entry.player = m_currentPlayer;
+    entry.condition_object = m_conditionObject;
+    entry.calling_object = m_callingObject;
+#endif
+}
+
+bool ScriptEngine::Evaluate_Condition_Uncached(Condition *condition)
 {
     bool ret;
 
@@ -6533,6 +6661,7 @@ void ScriptEngine::Add_Object_To_Cache(Object *obj)
 {
     if (obj != nullptr) {
         Utf8String name = obj->Get_Name();
+        Notify_Of_Object_State_Change();
 
         if (!(name == Utf8String::s_emptyString)) {
             auto it = m_namedObjects.begin();
@@ -6582,6 +6711,8 @@ void ScriptEngine::Add_Object_To_Cache(Object *obj)
 
 void ScriptEngine::Remove_Object_From_Cache(Object *obj)
 {
+    Notify_Of_Object_State_Change();
+
     for (auto it = m_namedObjects.begin(); it != m_namedObjects.end(); it++) {
         if (obj == it->second) {
             it->second = nullptr;
@@ -6597,6 +6728,7 @@ void ScriptEngine::Transfer_Object_Name(const Utf8String &obj_name, Object *obj)
         }
 
         obj->Set_Name(obj_name);
+        Notify_Of_Object_State_Change();
 
         for (auto it = m_namedObjects.begin(); it != m_namedObjects.end(); it++) {
             if (obj_name.Compare(it->first) == 0) {
@@ -6665,6 +6797,7 @@ void ScriptEngine::Notify_Of_Acquired_Science(int player_idx, ScienceType scienc
 void ScriptEngine::Signal_UI_Interact(const Utf8String &hook_name)
 {
     m_uiInteraction.push_back(hook_name);
+    Mark_UI_Interaction_Dirty();
     Append_Debug_Message(hook_name, false);
 }
 
@@ -7071,6 +7204,7 @@ ConditionTemplate *ScriptEngine::Get_Condition_Template(int index)
 void ScriptEngine::Create_Named_Cache()
 {
     m_namedObjects.clear();
+    Notify_Of_Object_State_Change();
 
     if (g_theGameLogic != nullptr) {
         for (Object *obj = g_theGameLogic->Get_First_Object(); obj != nullptr; obj = obj->Get_Next_Object()) {
@@ -7148,6 +7282,8 @@ void ScriptEngine::Remove_All_Sequential_Scripts(Team *team)
 void ScriptEngine::Notify_Of_Team_Destruction(Team *team_destroyed)
 {
     if (team_destroyed != nullptr) {
+        Notify_Of_Object_State_Change();
+
         for (auto it = m_sequentialScripts.begin(); it != m_sequentialScripts.end();) {
             if (*it != nullptr) {
                 if ((*it)->m_teamToExecOn == team_destroyed) {
@@ -7171,6 +7307,83 @@ void ScriptEngine::Notify_Of_Team_Destruction(Team *team_destroyed)
 void ScriptEngine::Notify_Of_Object_Creation_Or_Destruction()
 {
     m_objectCreationDestructionFrame = g_theGameLogic->Get_Frame();
+    Notify_Of_Object_State_Change();
+}
+
+/**
+ * Marks anything that condition results about named objects and teams are derived from as dirty, such as an object dying,
+ * being destroyed, changing team or a team being created or activated.
+ */
+void ScriptEngine::Notify_Of_Object_State_Change()
+{
+#ifndef GAME_DLL
+    m_objectStateSerial = ++m_conditionSerial;
+#endif
+}
+
+void ScriptEngine::Notify_Of_Trigger_Area_Change()
+{
+#ifndef GAME_DLL
+    m_areaSerial = ++m_conditionSerial;
+#endif
+}
+
+void ScriptEngine::Invalidate_Condition_Cache()
+{
+#ifndef GAME_DLL
+    m_conditionInvalidateSerial = ++m_conditionSerial;
+    m_uiInteractionSerial = m_conditionInvalidateSerial;
+    m_objectStateSerial = m_conditionInvalidateSerial;
+    m_areaSerial = m_conditionInvalidateSerial;
+
+    for (int i = 0; i < MAX_COUNTERS; i++) {
+        m_counterSerials[i] = m_conditionInvalidateSerial;
+    }
+
+    for (int i = 0; i < MAX_FLAGS; i++) {
+        m_flagSerials[i] = m_conditionInvalidateSerial;
+    }
+#endif
+}
+
+void ScriptEngine::Set_Condition_Cache_Mode(ConditionCacheMode mode)
+{
+#ifndef GAME_DLL
+    if (m_conditionCacheMode != mode) {
+        m_conditionCacheMode = mode;
+        Invalidate_Condition_Cache();
+    }
+#endif
+}
+
+ScriptEngine::ConditionCacheMode ScriptEngine::Get_Condition_Cache_Mode() const
+{
+#ifndef GAME_DLL
+    return m_conditionCacheMode;
+#else
+    return CONDITION_CACHE_OFF;
+#endif
+}
+
+void ScriptEngine::Mark_Counter_Dirty(int counter)
+{
+#ifndef GAME_DLL
+    m_counterSerials[counter] = ++m_conditionSerial;
+#endif
+}
+
+void ScriptEngine::Mark_Flag_Dirty(int flag)
+{
+#ifndef GAME_DLL
+    m_flagSerials[flag] = ++m_conditionSerial;
+#endif
+}
+
+void ScriptEngine::Mark_UI_Interaction_Dirty()
+{
+#ifndef GAME_DLL
+    m_uiInteractionSerial = ++m_conditionSerial;
+#endif
 }
 
 void ScriptEngine::Set_Sequential_Timer(Object *obj, int timer)
@@ -7737,6 +7950,10 @@ void Xfer_List_AsciiString_Coord3D(Xfer *xfer, std::list<std::pair<Utf8String, C
 
 void ScriptEngine::Xfer_Snapshot(Xfer *xfer)
 {
+    if (xfer->Get_Mode() == XFER_LOAD) {
+        Invalidate_Condition_Cache();
+    }
+
     unsigned char version = 5;
     xfer->xferVersion(&version, 5);
     unsigned short sequential_script_count = static_cast<unsigned short>(m_sequentialScripts.size());
@@ -7988,6 +8205,7 @@ void ScriptEngine::Xfer_Snapshot(Xfer *xfer)
 
 void ScriptEngine::Load_Post_Process()
 {
+    Invalidate_Condition_Cache();
     g_theScriptActions->Do_Enable_Or_Disable_Object_Difficulty_Bonuses(m_useObjectDifficultyBonuses);
 
     if (m_currentTrackName.Is_Not_Empty()) {
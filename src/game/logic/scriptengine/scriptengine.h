@@ -129,6 +129,13 @@ public:
         FADE_MULTIPLY,
     };
 
+    enum ConditionCacheMode
+    {
+        CONDITION_CACHE_OFF, // Evaluate every condition every time.
+        CONDITION_CACHE_ON, // Reuse results until an input of the condition is dirtied.
+        CONDITION_CACHE_VERIFY, // Evaluate both ways and assert the results match.
+    };
+
     ScriptEngine();
 
 #ifdef GAME_DLL
@@ -195,6 +202,11 @@ public:
     virtual Script *Find_Script_By_Name(const Utf8String &script_name);
 
     void Notify_Of_Object_Creation_Or_Destruction();
+    void Notify_Of_Object_State_Change();
+    void Notify_Of_Trigger_Area_Change();
+    void Invalidate_Condition_Cache();
+    void Set_Condition_Cache_Mode(ConditionCacheMode mode);
+    ConditionCacheMode Get_Condition_Cache_Mode() const;
 
     void Set_Global_Difficulty(GameDifficulty diff);
     Utf8String Get_Stats(float *slowest_scripts, float *time_last_frame, float *time);
@@ -238,6 +250,7 @@ public:
     void Execute_Scripts(Script *script);
     void Execute_Script(Script *script);
     bool Evaluate_Condition(Condition *condition);
+    bool Evaluate_Condition_Uncached(Condition *condition);
     void Set_Topple_Direction(const Utf8String &name, const Coord3D *direction);
     void Execute_Actions(ScriptAction *action);
     void Create_Named_Cache();
@@ -291,6 +304,12 @@ private:
         std::vector<SequentialScript *>::iterator it, bool delete_sequence);
     void Remove_Object_Types(ObjectTypes *obj);
 
+    void Mark_Counter_Dirty(int counter);
+    void Mark_Flag_Dirty(int flag);
+    void Mark_UI_Interaction_Dirty();
+    bool Is_Condition_Cache_Valid(Condition *condition);
+    void Cache_Condition_Result(Condition *condition, unsigned int serial, bool result);
+
     void Add_Action_Template_Info(Template *tmplate);
     void Add_Condition_Template_Info(Template *tmplate);
 
@@ -369,6 +388,16 @@ private:
     double m_maxUpdateTime;
     double m_frameUpdateTime;
 #endif
+#ifndef GAME_DLL
+    ConditionCacheMode m_conditionCacheMode;
+    unsigned int m_conditionSerial;
+    unsigned int m_conditionInvalidateSerial;
+    unsigned int m_counterSerials[MAX_COUNTERS];
+    unsigned int m_flagSerials[MAX_FLAGS];
+    unsigned int m_uiInteractionSerial;
+    unsigned int m_objectStateSerial;
+    unsigned int m_areaSerial;
+#endif
 
     static bool s_canAppContinue;
     static int s_currentFrame;
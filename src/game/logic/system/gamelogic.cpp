@@ -438,6 +438,7 @@ void GameLogic::Destroy_Object(Object *obj)
         }
 
         obj->Set_Status(BitFlags<OBJECT_STATUS_COUNT>(BitFlags<OBJECT_STATUS_COUNT>::kInit, OBJECT_STATUS_DESTROYED), true);
+        g_theScriptEngine->Notify_Of_Object_State_Change();
         AIUpdateInterface *update = obj->Get_AI_Update_Interface();
 
         if (update != nullptr) {
@@ -42,6 +42,7 @@
 #include "w3dwater.h"
 #include "w3dwaypointbuffer.h"
 #include "water.h"
+#include <algorithm>
 
 #ifndef GAME_DLL
 BaseHeightMapRenderObjClass *g_theTerrainRenderObject;
@@ -390,19 +391,97 @@ void BaseHeightMapRenderObjClass::Clear_All_Scorches()
     m_scorchesInBuffer = 0;
 }
 
+#ifndef GAME_DLL
+static bool Cell_Row_Less(const ICoord2D &a, const ICoord2D &b)
+{
+    return a.y < b.y || (a.y == b.y && a.x < b.x);
+}
+
+static bool Clip_Segment_Axis(float p0, float dp, float lo, float hi, float &t0, float &t1)
+{
+    if (dp == 0.0f) {
+        return p0 >= lo && p0 <= hi;
+    }
+
+    float ta = (lo - p0) / dp;
+    float tb = (hi - p0) / dp;
+
+    if (ta > tb) {
+        std::swap(ta, tb);
+    }
+
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+    return t0 <= t1;
+}
+
+/**
+ * @brief Collects the cells from x0, y0 to x1, y1 that a ray could hit a triangle of.
+ *
+ * CollisionMath::Collide only reports points the triangle contains that are within rounding of its plane, so a ray can
+ * only hit cells whose bounds it passes through. Blocks of cells the ray misses the bounds of are dropped whole.
+ */
+void BaseHeightMapRenderObjClass::Collect_Ray_Cells(const HeightPyramidClass *pyramid,
+    const LineSegClass &ray,
+    int x0,
+    int y0,
+    int x1,
+    int y1,
+    std::vector<ICoord2D> &cells) const
+{
+    const float margin = 0.5f;
+    unsigned char lowest;
+    unsigned char highest;
+    pyramid->Get_Range(x0, y0, x1 + 1, y1 + 1, lowest, highest);
+
+    float min_x = (x0 - m_map->Border_Size()) * 10.0f - margin;
+    float min_y = (y0 - m_map->Border_Size()) * 10.0f - margin;
+    float max_x = (x1 + 1 - m_map->Border_Size()) * 10.0f + margin;
+    float max_y = (y1 + 1 - m_map->Border_Size()) * 10.0f + margin;
+    float min_z = lowest * HEIGHTMAP_SCALE - margin;
+    float max_z = highest * HEIGHTMAP_SCALE + margin;
+    const Vector3 &p0 = ray.Get_P0();
+    const Vector3 &dp = ray.Get_DP();
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+
+    if (!Clip_Segment_Axis(p0.X, dp.X, min_x, max_x, t0, t1) || !Clip_Segment_Axis(p0.Y, dp.Y, min_y, max_y, t0, t1)
+        || !Clip_Segment_Axis(p0.Z, dp.Z, min_z, max_z, t0, t1)) {
+        return;
+    }
+
+    if (x0 == x1 && y0 == y1) {
+        ICoord2D cell;
+        cell.x = x0;
+        cell.y = y0;
+        cells.push_back(cell);
+    } else if (x1 - x0 >= y1 - y0) {
+        int mid = x0 + (x1 - x0) / 2;
+        Collect_Ray_Cells(pyramid, ray, x0, y0, mid, y1, cells);
+        Collect_Ray_Cells(pyramid, ray, mid + 1, y0, x1, y1, cells);
+    } else {
+        int mid = y0 + (y1 - y0) / 2;
+        Collect_Ray_Cells(pyramid, ray, x0, y0, x1, mid, cells);
+        Collect_Ray_Cells(pyramid, ray, x0, mid + 1, x1, y1, cells);
+    }
+}
+#endif
+
 bool BaseHeightMapRenderObjClass::Cast_Ray(RayCollisionTestClass &raytest)
 {
     bool hit = false;
-    Vector3 normal;
     Vector3 p0;
     Vector3 p1;
-    Vector3 p2;
-    Vector3 p3;
 
     if (m_map == nullptr) {
         return false;
     }
 
+#ifndef GAME_DLL
+    // Without a pyramid the ray is cast against every cell in its bounds as the original does.
+    const HeightPyramidClass *pyramid = m_map->Get_Height_Pyramid();
+#endif
+
     AABoxClass hbox;
     LineSegClass lineseg;
     LineSegClass lineseg2;
@@ -468,16 +547,32 @@ bool BaseHeightMapRenderObjClass::Cast_Ray(RayCollisionTestClass &raytest)
         int max_ht = m_map->Get_Max_Height_Value();
         int min_ht = 0;
 
-        for (int cell_y = start_cell_y; cell_y <= end_cell_y; cell_y++) {
-            for (int cell_x = start_cell_x; cell_x <= end_cell_x; cell_x++) {
-                unsigned char clip = Get_Clip_Height(m_map->Border_Size() + cell_x, m_map->Border_Size() + cell_y);
+#ifndef GAME_DLL
+        if (pyramid != nullptr) {
+            unsigned char lowest;
+            unsigned char highest;
+            pyramid->Get_Range(m_map->Border_Size() + start_cell_x,
+                m_map->Border_Size() + start_cell_y,
+                m_map->Border_Size() + end_cell_x,
+                m_map->Border_Size() + end_cell_y,
+                lowest,
+                highest);
+            max_ht = lowest;
+            min_ht = highest;
+        } else
+#endif
+        {
+            for (int cell_y = start_cell_y; cell_y <= end_cell_y; cell_y++) {
+                for (int cell_x = start_cell_x; cell_x <= end_cell_x; cell_x++) {
+                    unsigned char clip = Get_Clip_Height(m_map->Border_Size() + cell_x, m_map->Border_Size() + cell_y);
 
-                if (clip < max_ht) {
-                    max_ht = clip;
-                }
+                    if (clip < max_ht) {
+                        max_ht = clip;
+                    }
 
-                if (min_ht < clip) {
-                    min_ht = clip;
+                    if (min_ht < clip) {
+                        min_ht = clip;
+                    }
                 }
             }
         }
@@ -494,46 +589,34 @@ bool BaseHeightMapRenderObjClass::Cast_Ray(RayCollisionTestClass &raytest)
     end_cell_x += m_map->Border_Size();
     end_cell_y += m_map->Border_Size();
 
-    for (int m = 1; m < 5; m *= 3) {
-        for (int y = start_cell_y - m; y <= m + end_cell_y; y++) {
-            for (int x = start_cell_x - m; x <= m + end_cell_x; x++) {
-                p0.X = (x - m_map->Border_Size()) * 10.0f;
-                p0.Y = (y - m_map->Border_Size()) * 10.0f;
-                p0.Z = Get_Clip_Height(x, y) * HEIGHTMAP_SCALE;
-
-                p1.X = (x + 1 - m_map->Border_Size()) * 10.0f;
-                p1.Y = (y - m_map->Border_Size()) * 10.0f;
-                p1.Z = Get_Clip_Height(x + 1, y) * HEIGHTMAP_SCALE;
-
-                p2.X = (x + 1 - m_map->Border_Size()) * 10.0f;
-                p2.Y = (y + 1 - m_map->Border_Size()) * 10.0f;
-                p2.Z = Get_Clip_Height(x + 1, y + 1) * HEIGHTMAP_SCALE;
-
-                p3.X = (x - m_map->Border_Size()) * 10.0f;
-                p3.Y = (y + 1 - m_map->Border_Size()) * 10.0f;
-                p3.Z = Get_Clip_Height(x, y + 1) * HEIGHTMAP_SCALE;
-
-                TriClass tri;
-                tri.V[0] = &p0;
-                tri.V[1] = &p1;
-                tri.V[2] = &p2;
-                tri.N = &normal;
-                tri.Compute_Normal();
-                hit |= CollisionMath::Collide(raytest.m_ray, tri, raytest.m_result);
-
-                if (raytest.m_result->start_bad) {
+#ifndef GAME_DLL
+    // Only the cells the ray can possibly touch are tested, in the same order as below. A result that already started bad
+    // makes the loop below return at its first cell, so that case is left to it.
+    if (pyramid != nullptr && !raytest.m_result->start_bad) {
+        std::vector<ICoord2D> cells;
+
+        for (int m = 1; m < 5; m *= 3) {
+            cells.clear();
+            Collect_Ray_Cells(
+                pyramid, raytest.m_ray, start_cell_x - m, start_cell_y - m, end_cell_x + m, end_cell_y + m, cells);
+            std::sort(cells.begin(), cells.end(), Cell_Row_Less);
+
+            for (const ICoord2D &cell : cells) {
+                if (!Cast_Ray_Cell(raytest, cell.x, cell.y, hit)) {
                     return true;
                 }
+            }
+        }
 
-                tri.V[0] = &p2;
-                tri.V[1] = &p3;
-                tri.V[2] = &p0;
-                tri.N = &normal;
-                tri.Compute_Normal();
-                hit |= CollisionMath::Collide(raytest.m_ray, tri, raytest.m_result);
+        return hit;
+    }
+#endif
 
-                if (hit) {
-                    raytest.m_result->surface_type = SURFACE_TYPE_DEFAULT;
+    for (int m = 1; m < 5; m *= 3) {
+        for (int y = start_cell_y - m; y <= m + end_cell_y; y++) {
+            for (int x = start_cell_x - m; x <= m + end_cell_x; x++) {
+                if (!Cast_Ray_Cell(raytest, x, y, hit)) {
+                    return true;
                 }
             }
         }
@@ -542,6 +625,59 @@ bool BaseHeightMapRenderObjClass::Cast_Ray(RayCollisionTestClass &raytest)
     return hit;
 }
 
+/**
+ * @brief Tests a ray against the two triangles of a height map cell, returning false if the ray started bad.
+ */
+bool BaseHeightMapRenderObjClass::Cast_Ray_Cell(RayCollisionTestClass &raytest, int x, int y, bool &hit)
+{
+    Vector3 normal;
+    Vector3 p0;
+    Vector3 p1;
+    Vector3 p2;
+    Vector3 p3;
+
+    p0.X = (x - m_map->Border_Size()) * 10.0f;
+    p0.Y = (y - m_map->Border_Size()) * 10.0f;
+    p0.Z = Get_Clip_Height(x, y) * HEIGHTMAP_SCALE;
+
+    p1.X = (x + 1 - m_map->Border_Size()) * 10.0f;
+    p1.Y = (y - m_map->Border_Size()) * 10.0f;
+    p1.Z = Get_Clip_Height(x + 1, y) * HEIGHTMAP_SCALE;
+
+    p2.X = (x + 1 - m_map->Border_Size()) * 10.0f;
+    p2.Y = (y + 1 - m_map->Border_Size()) * 10.0f;
+    p2.Z = Get_Clip_Height(x + 1, y + 1) * HEIGHTMAP_SCALE;
+
+    p3.X = (x - m_map->Border_Size()) * 10.0f;
+    p3.Y = (y + 1 - m_map->Border_Size()) * 10.0f;
+    p3.Z = Get_Clip_Height(x, y + 1) * HEIGHTMAP_SCALE;
+
+    TriClass tri;
+    tri.V[0] = &p0;
+    tri.V[1] = &p1;
+    tri.V[2] = &p2;
+    tri.N = &normal;
+    tri.Compute_Normal();
+    hit |= CollisionMath::Collide(raytest.m_ray, tri, raytest.m_result);
+
+    if (raytest.m_result->start_bad) {
+        return false;
+    }
+
+    tri.V[0] = &p2;
+    tri.V[1] = &p3;
+    tri.V[2] = &p0;
+    tri.N = &normal;
+    tri.Compute_Normal();
+    hit |= CollisionMath::Collide(raytest.m_ray, tri, raytest.m_result);
+
+    if (hit) {
+        raytest.m_result->surface_type = SURFACE_TYPE_DEFAULT;
+    }
+
+    return true;
+}
+
 void BaseHeightMapRenderObjClass::Get_Obj_Space_Bounding_Sphere(SphereClass &sphere) const
 {
     int x = 0;
@@ -1327,11 +1463,114 @@ bool BaseHeightMapRenderObjClass::Is_Clear_Line_Of_Sight(const Coord3D &pos1, co
     unsigned char *height_data = height_map->Get_Data_Ptr();
     int x_extent = height_map->Get_X_Extent();
     int y_extent = height_map->Get_Y_Extent();
+#ifndef GAME_DLL
+    const HeightPyramidClass *pyramid = height_map->Get_Height_Pyramid();
+    // Short lines are quicker to just walk than to look up blocks for.
+    int top_level = pyramid != nullptr && major_extent >= 32 ? pyramid->Get_Level_Count() - 1 : 0;
+    int skip_level = 0;
+
+    // Start with the largest blocks that are no longer than the line.
+    while (skip_level < top_level && (2 << skip_level) <= major_extent) {
+        skip_level++;
+    }
+
+    int next_skip = 0;
+    int skip_backoff = 1;
+#endif
 
     // Iterate over the height map to check for obstructions
     for (int i = 0; i < major_extent && current_x_pos >= 0 && current_y_pos >= 0 && current_x_pos < x_extent - 1
          && current_y_pos < y_extent - 1;
          i++) {
+#ifndef GAME_DLL
+        // Step over the cells of a block the line stays above for as long as it is inside of it. The height is still
+        // advanced a step at a time so that it comes out exactly as it would have from the steps skipped.
+        int skipped = 0;
+
+        for (int level = i >= next_skip ? skip_level : 0; level > 0 && skipped == 0; level--) {
+            int block_lo_x = (current_x_pos >> level) << level;
+            int block_lo_y = (current_y_pos >> level) << level;
+            int block_hi_x = std::min(block_lo_x + (1 << level), x_extent - 1) - 1;
+            int block_hi_y = std::min(block_lo_y + (1 << level), y_extent - 1) - 1;
+            int major_cells;
+            int minor_cells;
+
+            if (x_increment_2 != 0) {
+                major_cells = x_increment_2 > 0 ? block_hi_x - current_x_pos + 1 : current_x_pos - block_lo_x + 1;
+                minor_cells = y_increment_1 > 0 ? block_hi_y - current_y_pos + 1 : current_y_pos - block_lo_y + 1;
+            } else {
+                major_cells = y_increment_2 > 0 ? block_hi_y - current_y_pos + 1 : current_y_pos - block_lo_y + 1;
+                minor_cells = x_increment_1 > 0 ? block_hi_x - current_x_pos + 1 : current_x_pos - block_lo_x + 1;
+            }
+
+            int steps = std::min(major_cells, major_extent - i);
+
+            if (minor_extent > 0) {
+                // The minor position has moved floor((minor_distance + steps * minor_extent) / major_distance) cells.
+                int64_t minor_steps =
+                    ((int64_t)minor_cells * major_distance - minor_distance + minor_extent - 1) / minor_extent;
+                steps = (int)std::min<int64_t>(steps, minor_steps);
+            }
+
+            if (steps < 2) {
+                continue;
+            }
+
+            float block_max_height = pyramid->Get_Cell_Block_Max(level, current_x_pos, current_y_pos) * HEIGHTMAP_SCALE;
+
+            if (height_increment < 0.0f && current_height + height_increment * (steps - 1) + 0.5f < block_max_height) {
+                continue;
+            }
+
+            if (height_increment >= 0.0f && current_height + 0.5f < block_max_height) {
+                continue;
+            }
+
+            // A line that is not going down and ends inside of the block is clear, whether or not it gets above the
+            // highest terrain first.
+            if (height_increment >= 0.0f && steps == major_extent - i) {
+                return true;
+            }
+
+            float last_height = current_height;
+
+            for (int j = 1; j < steps; j++) {
+                last_height += height_increment;
+            }
+
+            if (last_height + 0.5f < block_max_height) {
+                continue;
+            }
+
+            if (Get_Max_Height() <= last_height && height_increment > 0.0f) {
+                return true;
+            }
+
+            int64_t distance = (int64_t)minor_distance + (int64_t)steps * minor_extent;
+            int minor_moves = (int)(distance / major_distance);
+            minor_distance = (int)(distance - (int64_t)minor_moves * major_distance);
+            current_height = last_height + height_increment;
+            current_x_pos += x_increment_1 * minor_moves + x_increment_2 * steps;
+            current_y_pos += y_increment_1 * minor_moves + y_increment_2 * steps;
+            skip_level = std::min(level + 1, top_level);
+            skipped = steps;
+        }
+
+        // Blocks only get one level larger after each skip, and where nothing could be skipped the line is close to the
+        // terrain, so it waits a little longer each time before trying again.
+        if (skipped != 0) {
+            skip_backoff = 1;
+            i += skipped - 1;
+            continue;
+        }
+
+        if (i >= next_skip && top_level > 0) {
+            skip_level = 1;
+            next_skip = i + skip_backoff;
+            skip_backoff = std::min(skip_backoff * 2, 16);
+        }
+#endif
+
         int map_index = x_extent * current_y_pos + current_x_pos;
         float max_height_1;
 
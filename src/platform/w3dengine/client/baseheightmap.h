@@ -41,6 +41,7 @@ class FrustumClass;
 class GeometryInfo;
 class GameAssetManager;
 class SimpleSceneClass;
+class LineSegClass;
 
 struct ShorelineTile
 {
@@ -216,6 +217,17 @@ public:
     }
 
 protected:
+    bool Cast_Ray_Cell(RayCollisionTestClass &raytest, int x, int y, bool &hit);
+#ifndef GAME_DLL
+    void Collect_Ray_Cells(const HeightPyramidClass *pyramid,
+        const LineSegClass &ray,
+        int x0,
+        int y0,
+        int x1,
+        int y1,
+        std::vector<ICoord2D> &cells) const;
+#endif
+
     int m_x;
     int m_y;
     DX8VertexBufferClass *m_vertexScorch;
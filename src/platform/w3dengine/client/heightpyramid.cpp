@@ -0,0 +1,157 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Lowest and highest heights of square blocks of a height map.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include "heightpyramid.h"
+#include <algorithm>
+
+HeightPyramidClass::HeightPyramidClass() : m_data(nullptr), m_width(0), m_height(0) {}
+
+/**
+ * @brief Builds every level for a height map of width by height points.
+ */
+void HeightPyramidClass::Build(const unsigned char *data, int width, int height)
+{
+    m_data = data;
+    m_width = width;
+    m_height = height;
+    m_levels.clear();
+
+    if (data == nullptr || width <= 0 || height <= 0) {
+        m_width = 0;
+        m_height = 0;
+        return;
+    }
+
+    for (int level = 1; Get_Level_Width(level - 1) > 1 || Get_Level_Height(level - 1) > 1; ++level) {
+        LevelStruct lvl;
+        lvl.m_width = Get_Level_Width(level);
+        int size = lvl.m_width * Get_Level_Height(level);
+        lvl.m_min.resize(size);
+        lvl.m_max.resize(size);
+        m_levels.push_back(lvl);
+
+        for (int y = 0; y < Get_Level_Height(level); ++y) {
+            for (int x = 0; x < lvl.m_width; ++x) {
+                Update_Block(level, x, y);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Refreshes the blocks holding a height map point after its height changed.
+ */
+void HeightPyramidClass::Update(int x, int y)
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return;
+    }
+
+    for (int level = 1; level < Get_Level_Count(); ++level) {
+        Update_Block(level, x >> level, y >> level);
+    }
+}
+
+void HeightPyramidClass::Update_Block(int level, int x, int y)
+{
+    int child_width = Get_Level_Width(level - 1);
+    int child_height = Get_Level_Height(level - 1);
+    int child_x = x * 2;
+    int child_y = y * 2;
+    unsigned char min_height = Get_Block_Min(level - 1, child_x, child_y);
+    unsigned char max_height = Get_Block_Max(level - 1, child_x, child_y);
+
+    for (int j = child_y; j < child_y + 2 && j < child_height; ++j) {
+        for (int i = child_x; i < child_x + 2 && i < child_width; ++i) {
+            min_height = std::min(min_height, Get_Block_Min(level - 1, i, j));
+            max_height = std::max(max_height, Get_Block_Max(level - 1, i, j));
+        }
+    }
+
+    LevelStruct &lvl = m_levels[level - 1];
+    lvl.m_min[x + lvl.m_width * y] = min_height;
+    lvl.m_max[x + lvl.m_width * y] = max_height;
+}
+
+/**
+ * @brief Gets the lowest and highest height of the points from x0, y0 to x1, y1 inclusive. Coordinates off the map are
+ * clamped to its edge, the same way BaseHeightMapRenderObjClass::Get_Clip_Height clamps them.
+ */
+void HeightPyramidClass::Get_Range(
+    int x0, int y0, int x1, int y1, unsigned char &min_height, unsigned char &max_height) const
+{
+    x0 = std::clamp(x0, 0, m_width - 1);
+    y0 = std::clamp(y0, 0, m_height - 1);
+    x1 = std::clamp(x1, 0, m_width - 1);
+    y1 = std::clamp(y1, 0, m_height - 1);
+    min_height = 255;
+    max_height = 0;
+    Get_Block_Range(Get_Level_Count() - 1, 0, 0, x0, y0, x1, y1, min_height, max_height);
+}
+
+void HeightPyramidClass::Get_Block_Range(int level, int x, int y, int x0, int y0, int x1, int y1,
+    unsigned char &min_height, unsigned char &max_height) const
+{
+    int lo_x = x << level;
+    int lo_y = y << level;
+    int hi_x = std::min(((x + 1) << level) - 1, m_width - 1);
+    int hi_y = std::min(((y + 1) << level) - 1, m_height - 1);
+
+    if (lo_x > x1 || lo_y > y1 || hi_x < x0 || hi_y < y0) {
+        return;
+    }
+
+    if (lo_x >= x0 && lo_y >= y0 && hi_x <= x1 && hi_y <= y1) {
+        min_height = std::min(min_height, Get_Block_Min(level, x, y));
+        max_height = std::max(max_height, Get_Block_Max(level, x, y));
+        return;
+    }
+
+    int child_width = Get_Level_Width(level - 1);
+    int child_height = Get_Level_Height(level - 1);
+
+    for (int j = y * 2; j < y * 2 + 2 && j < child_height; ++j) {
+        for (int i = x * 2; i < x * 2 + 2 && i < child_width; ++i) {
+            Get_Block_Range(level - 1, i, j, x0, y0, x1, y1, min_height, max_height);
+        }
+    }
+}
+
+/**
+ * @brief Gets a height at least as high as every corner of the cells in the block of 2^level by 2^level cells holding a
+ * cell. At level zero this is exactly the highest corner of the cell itself.
+ */
+unsigned char HeightPyramidClass::Get_Cell_Block_Max(int level, int cell_x, int cell_y) const
+{
+    int x = cell_x >> level;
+    int y = cell_y >> level;
+    int width = Get_Level_Width(level);
+    int height = Get_Level_Height(level);
+    unsigned char max_height = Get_Block_Max(level, x, y);
+
+    // The corners along the far edges of the block belong to the next blocks over.
+    if (x + 1 < width) {
+        max_height = std::max(max_height, Get_Block_Max(level, x + 1, y));
+    }
+
+    if (y + 1 < height) {
+        max_height = std::max(max_height, Get_Block_Max(level, x, y + 1));
+
+        if (x + 1 < width) {
+            max_height = std::max(max_height, Get_Block_Max(level, x + 1, y + 1));
+        }
+    }
+
+    return max_height;
+}
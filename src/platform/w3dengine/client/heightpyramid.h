@@ -0,0 +1,76 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Lowest and highest heights of square blocks of a height map.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#pragma once
+
+#include "always.h"
+#include <vector>
+
+// Level N keeps the lowest and highest height of each block of 2^N by 2^N height map points, up to a level with a
+// single block covering the whole map. Level zero is the height data itself, which the pyramid reads but does not own,
+// so code walking the terrain can rule out whole blocks at once and only look at single points where it has to.
+class HeightPyramidClass
+{
+public:
+    HeightPyramidClass();
+
+    void Build(const unsigned char *data, int width, int height);
+    void Update(int x, int y);
+
+    int Get_Level_Count() const { return int(m_levels.size()) + 1; }
+    int Get_Level_Width(int level) const { return (m_width + (1 << level) - 1) >> level; }
+    int Get_Level_Height(int level) const { return (m_height + (1 << level) - 1) >> level; }
+    unsigned char Get_Block_Min(int level, int x, int y) const;
+    unsigned char Get_Block_Max(int level, int x, int y) const;
+
+    void Get_Range(int x0, int y0, int x1, int y1, unsigned char &min_height, unsigned char &max_height) const;
+    unsigned char Get_Cell_Block_Max(int level, int cell_x, int cell_y) const;
+
+private:
+    struct LevelStruct
+    {
+        int m_width;
+        std::vector<unsigned char> m_min;
+        std::vector<unsigned char> m_max;
+    };
+
+    void Update_Block(int level, int x, int y);
+    void Get_Block_Range(int level, int x, int y, int x0, int y0, int x1, int y1, unsigned char &min_height,
+        unsigned char &max_height) const;
+
+    const unsigned char *m_data;
+    int m_width;
+    int m_height;
+    std::vector<LevelStruct> m_levels; // Level N is at index N - 1.
+};
+
+inline unsigned char HeightPyramidClass::Get_Block_Min(int level, int x, int y) const
+{
+    if (level == 0) {
+        return m_data[x + m_width * y];
+    }
+
+    const LevelStruct &lvl = m_levels[level - 1];
+    return lvl.m_min[x + lvl.m_width * y];
+}
+
+inline unsigned char HeightPyramidClass::Get_Block_Max(int level, int x, int y) const
+{
+    if (level == 0) {
+        return m_data[x + m_width * y];
+    }
+
+    const LevelStruct &lvl = m_levels[level - 1];
+    return lvl.m_max[x + lvl.m_width * y];
+}
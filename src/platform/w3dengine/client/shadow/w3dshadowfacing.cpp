@@ -0,0 +1,233 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Classifies shadow caster polygons against a light several at a time and caches the silhouettes found.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include "w3dshadowfacing.h"
+#include <cstring>
+
+#if defined PROCESSOR_X86 || defined PROCESSOR_X86_64
+#include <xmmintrin.h>
+#define SHADOWFACING_SSE
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define SHADOWFACING_NEON
+#endif
+
+enum
+{
+    FACING_BATCH_WIDTH = 4,
+    FACING_WORD_BITS = 32,
+    SILHOUETTE_CACHE_SIZE = 8,
+};
+
+ShadowFacingBatchClass::ShadowFacingBatchClass() :
+    m_vertexX(nullptr),
+    m_vertexY(nullptr),
+    m_vertexZ(nullptr),
+    m_normalX(nullptr),
+    m_normalY(nullptr),
+    m_normalZ(nullptr),
+    m_count(0)
+{
+}
+
+ShadowFacingBatchClass::~ShadowFacingBatchClass()
+{
+    Free();
+}
+
+void ShadowFacingBatchClass::Free()
+{
+    delete[] m_vertexX;
+    delete[] m_vertexY;
+    delete[] m_vertexZ;
+    delete[] m_normalX;
+    delete[] m_normalY;
+    delete[] m_normalZ;
+    m_vertexX = nullptr;
+    m_vertexY = nullptr;
+    m_vertexZ = nullptr;
+    m_normalX = nullptr;
+    m_normalY = nullptr;
+    m_normalZ = nullptr;
+    m_count = 0;
+}
+
+/**
+ * @brief Makes room for a number of polygons, all of them starting out with a zero normal.
+ */
+void ShadowFacingBatchClass::Init(int count)
+{
+    Free();
+
+    if (count <= 0) {
+        return;
+    }
+
+    // Pad to a whole word of polygons so the wide loop never needs a scalar tail. The padding keeps a zero normal, which
+    // gives a dot product of zero or NaN and so never faces the light.
+    int padded = (count + FACING_WORD_BITS - 1) & ~(FACING_WORD_BITS - 1);
+
+    m_vertexX = new float[padded];
+    m_vertexY = new float[padded];
+    m_vertexZ = new float[padded];
+    m_normalX = new float[padded];
+    m_normalY = new float[padded];
+    m_normalZ = new float[padded];
+    memset(m_vertexX, 0, padded * sizeof(float));
+    memset(m_vertexY, 0, padded * sizeof(float));
+    memset(m_vertexZ, 0, padded * sizeof(float));
+    memset(m_normalX, 0, padded * sizeof(float));
+    memset(m_normalY, 0, padded * sizeof(float));
+    memset(m_normalZ, 0, padded * sizeof(float));
+    m_count = count;
+}
+
+void ShadowFacingBatchClass::Set_Polygon(int index, const Vector3 &vertex, const Vector3 &normal)
+{
+    captainslog_assert(index >= 0 && index < m_count);
+    m_vertexX[index] = vertex.X;
+    m_vertexY[index] = vertex.Y;
+    m_vertexZ[index] = vertex.Z;
+    m_normalX[index] = normal.X;
+    m_normalY[index] = normal.Y;
+    m_normalZ[index] = normal.Z;
+}
+
+/**
+ * @brief Tests every polygon against a light position in the space of the mesh, setting bit index % 32 of word index /
+ * 32 for each polygon that faces the light. Facing must hold Get_Word_Count words.
+ */
+void ShadowFacingBatchClass::Classify(const Vector3 &light_pos, uint32_t *facing) const
+{
+    int word_count = Get_Word_Count();
+
+#if defined SHADOWFACING_SSE
+    __m128 light_x = _mm_set1_ps(light_pos.X);
+    __m128 light_y = _mm_set1_ps(light_pos.Y);
+    __m128 light_z = _mm_set1_ps(light_pos.Z);
+    __m128 zero = _mm_setzero_ps();
+
+    for (int word = 0; word < word_count; ++word) {
+        uint32_t bits = 0;
+
+        for (int bit = 0; bit < FACING_WORD_BITS; bit += FACING_BATCH_WIDTH) {
+            int i = word * FACING_WORD_BITS + bit;
+            __m128 x = _mm_sub_ps(_mm_loadu_ps(&m_vertexX[i]), light_x);
+            __m128 y = _mm_sub_ps(_mm_loadu_ps(&m_vertexY[i]), light_y);
+            __m128 z = _mm_sub_ps(_mm_loadu_ps(&m_vertexZ[i]), light_z);
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_loadu_ps(&m_normalX[i])),
+                                        _mm_mul_ps(y, _mm_loadu_ps(&m_normalY[i]))),
+                _mm_mul_ps(z, _mm_loadu_ps(&m_normalZ[i])));
+            bits |= uint32_t(_mm_movemask_ps(_mm_cmplt_ps(dot, zero))) << bit;
+        }
+
+        facing[word] = bits;
+    }
+#elif defined SHADOWFACING_NEON
+    float32x4_t light_x = vdupq_n_f32(light_pos.X);
+    float32x4_t light_y = vdupq_n_f32(light_pos.Y);
+    float32x4_t light_z = vdupq_n_f32(light_pos.Z);
+
+    for (int word = 0; word < word_count; ++word) {
+        uint32_t bits = 0;
+
+        for (int bit = 0; bit < FACING_WORD_BITS; bit += FACING_BATCH_WIDTH) {
+            int i = word * FACING_WORD_BITS + bit;
+            float32x4_t x = vsubq_f32(vld1q_f32(&m_vertexX[i]), light_x);
+            float32x4_t y = vsubq_f32(vld1q_f32(&m_vertexY[i]), light_y);
+            float32x4_t z = vsubq_f32(vld1q_f32(&m_vertexZ[i]), light_z);
+            // Separate multiplies and adds rather than fused ones so the results round like the scalar test.
+            float32x4_t dot = vaddq_f32(
+                vaddq_f32(vmulq_f32(x, vld1q_f32(&m_normalX[i])), vmulq_f32(y, vld1q_f32(&m_normalY[i]))),
+                vmulq_f32(z, vld1q_f32(&m_normalZ[i])));
+            uint32_t lanes[FACING_BATCH_WIDTH];
+            vst1q_u32(lanes, vcltq_f32(dot, vdupq_n_f32(0.0f)));
+
+            for (int lane = 0; lane < FACING_BATCH_WIDTH; ++lane) {
+                bits |= uint32_t(lanes[lane] & 1) << (bit + lane);
+            }
+        }
+
+        facing[word] = bits;
+    }
+#else
+    for (int word = 0; word < word_count; ++word) {
+        uint32_t bits = 0;
+
+        for (int bit = 0; bit < FACING_WORD_BITS; ++bit) {
+            int i = word * FACING_WORD_BITS + bit;
+            float dot = (m_vertexX[i] - light_pos.X) * m_normalX[i] + (m_vertexY[i] - light_pos.Y) * m_normalY[i]
+                + (m_vertexZ[i] - light_pos.Z) * m_normalZ[i];
+
+            if (dot < 0.0f) {
+                bits |= 1u << bit;
+            }
+        }
+
+        facing[word] = bits;
+    }
+#endif
+}
+
+namespace
+{
+uint32_t Hash_Facing(const uint32_t *facing, int word_count)
+{
+    uint32_t hash = 2166136261u;
+
+    for (int i = 0; i < word_count; ++i) {
+        hash = (hash ^ facing[i]) * 16777619u;
+    }
+
+    return hash;
+}
+} // namespace
+
+ShadowSilhouetteCacheClass::ShadowSilhouetteCacheClass() : m_nextEntry(0) {}
+
+/**
+ * @brief Gets the silhouette indices kept for a set of facing bits, or nullptr if there are none.
+ */
+const std::vector<short> *ShadowSilhouetteCacheClass::Find(const uint32_t *facing, int word_count) const
+{
+    uint32_t hash = Hash_Facing(facing, word_count);
+
+    for (const EntryStruct &entry : m_entries) {
+        if (entry.m_hash == hash && int(entry.m_facing.size()) == word_count
+            && memcmp(entry.m_facing.data(), facing, word_count * sizeof(uint32_t)) == 0) {
+            return &entry.m_indices;
+        }
+    }
+
+    return nullptr;
+}
+
+void ShadowSilhouetteCacheClass::Add(const uint32_t *facing, int word_count, const short *indices, int index_count)
+{
+    if (int(m_entries.size()) < SILHOUETTE_CACHE_SIZE) {
+        m_entries.emplace_back();
+    }
+
+    EntryStruct &entry = m_entries[m_nextEntry];
+    m_nextEntry = (m_nextEntry + 1) % SILHOUETTE_CACHE_SIZE;
+    entry.m_hash = Hash_Facing(facing, word_count);
+    entry.m_facing.assign(facing, facing + word_count);
+    entry.m_indices.assign(indices, indices + index_count);
+}
+
+void ShadowSilhouetteCacheClass::Reset()
+{
+    m_entries.clear();
+    m_nextEntry = 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Classifies shadow caster polygons against a light several at a time and caches the silhouettes found.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#pragma once
+
+#include "always.h"
+#include "vector3.h"
+#include <vector>
+
+// W3DVolumetricShadow::Build_Silhouette tests one polygon of a shadow caster mesh against the light at a time, looking
+// up its first vertex and normal through the mesh. Here the first vertex and normal of every polygon are copied into
+// flat arrays once and tested four at a time with SSE or NEON where available, giving one bit per polygon that is set
+// when it faces the light. A bit is set exactly when (vertex - light) * normal < 0 in the scalar test, as the arithmetic
+// is the same and only done for several polygons at once.
+class ShadowFacingBatchClass
+{
+public:
+    ShadowFacingBatchClass();
+    ~ShadowFacingBatchClass();
+
+    void Init(int count);
+    void Set_Polygon(int index, const Vector3 &vertex, const Vector3 &normal);
+    void Classify(const Vector3 &light_pos, uint32_t *facing) const;
+    int Get_Count() const { return m_count; }
+    int Get_Word_Count() const { return (m_count + 31) >> 5; }
+    void Free();
+
+    static bool Is_Facing(const uint32_t *facing, int index) { return ((facing[index >> 5] >> (index & 31)) & 1) != 0; }
+
+private:
+    float *m_vertexX;
+    float *m_vertexY;
+    float *m_vertexZ;
+    float *m_normalX;
+    float *m_normalY;
+    float *m_normalZ;
+    int m_count;
+};
+
+// The silhouette of a mesh only depends on which of its polygons face the light, so the edges found for a set of facing
+// bits are kept and handed back whenever the same set comes up again, whether for the same shadow a few frames later or
+// for another shadow of the same geometry. Only a few sets are kept per mesh, the oldest one making room for a new one.
+class ShadowSilhouetteCacheClass
+{
+public:
+    ShadowSilhouetteCacheClass();
+
+    const std::vector<short> *Find(const uint32_t *facing, int word_count) const;
+    void Add(const uint32_t *facing, int word_count, const short *indices, int index_count);
+    void Reset();
+
+private:
+    struct EntryStruct
+    {
+        uint32_t m_hash;
+        std::vector<uint32_t> m_facing;
+        std::vector<short> m_indices;
+    };
+
+    std::vector<EntryStruct> m_entries;
+    int m_nextEntry;
+};
@@ -69,6 +69,10 @@ W3DShadowGeometryMesh::W3DShadowGeometryMesh() :
     m_polyNeighbors(nullptr),
     m_numPolyNeighbors(0),
     m_parentGeometry(nullptr)
+#ifndef GAME_DLL
+    ,
+    m_facingLightPos(0.0f, 0.0f, 0.0f)
+#endif
 {
 }
 
@@ -275,6 +279,34 @@ void W3DShadowGeometryMesh::Get_Polygon_Index(int polygon_index, short *index_li
     index_list[2] = m_parentVerts[v->K];
 }
 
+#ifndef GAME_DLL
+/**
+ * @brief Gets a bit per polygon that is set when the polygon faces a light position in the space of the mesh, see
+ * ShadowFacingBatchClass::Classify. The bits stay valid until the next call.
+ */
+const uint32_t *W3DShadowGeometryMesh::Classify_Facing(const Vector3 &light_pos)
+{
+    if (m_facingBatch.Get_Count() != m_numPolygons) {
+        Build_Polygon_Normals();
+        m_facingBatch.Init(m_numPolygons);
+
+        for (int i = 0; i < m_numPolygons; ++i) {
+            short poly[3];
+            Get_Polygon_Index(i, poly);
+            m_facingBatch.Set_Polygon(i, *Get_Vertex(poly[0]), m_polygonNormals[i]);
+        }
+
+        m_facing.assign(m_facingBatch.Get_Word_Count(), 0);
+    } else if (light_pos == m_facingLightPos) {
+        return m_facing.data();
+    }
+
+    m_facingBatch.Classify(light_pos, m_facing.data());
+    m_facingLightPos = light_pos;
+    return m_facing.data();
+}
+#endif
+
 W3DShadowGeometry::W3DShadowGeometry() : m_name{}, m_meshCount(0), m_numTotalsVerts(0) {}
 
 void W3DShadowGeometry::Set_Name(const char *name)
@@ -1649,6 +1681,7 @@ void W3DVolumetricShadow::Build_Silhouette(int mesh_index, Vector3 *light_pos_ob
     mesh_edge_start = m_numSilhouetteIndices[mesh_index];
     int num_polys = mesh->Get_Num_Polygon();
 
+#ifdef GAME_DLL
     for (int poly_index = 0; poly_index < num_polys; poly_index++) {
         PolyNeighbor *us = mesh->Get_Poly_Neighbor(poly_index);
         us->status = 0;
@@ -1698,7 +1731,72 @@ void W3DVolumetricShadow::Build_Silhouette(int mesh_index, Vector3 *light_pos_ob
 
         us->status |= 2u;
     }
+#else
+    if (num_polys == 0) {
+        m_numIndicesPerMesh[mesh_index] = 0;
+        return;
+    }
+
+    // The edges only depend on which polygons face the light, so a set of facing bits seen before, by this shadow or
+    // another one of the same geometry, gets the edges found back then.
+    const uint32_t *facing = mesh->Classify_Facing(*light_pos_object);
+    int word_count = (num_polys + 31) >> 5;
+    ShadowSilhouetteCacheClass &cache = mesh->Get_Silhouette_Cache();
+    const std::vector<short> *cached = cache.Find(facing, word_count);
+
+    if (cached != nullptr) {
+        int count = int(cached->size());
+
+        if (count != 0) {
+            memcpy(&m_silhouetteIndex[mesh_index][mesh_edge_start], cached->data(), count * sizeof(short));
+        }
+
+        m_numSilhouetteIndices[mesh_index] += count;
+        m_numIndicesPerMesh[mesh_index] = count;
+        return;
+    }
+
+    // Same walk as above, finding the same edges in the same order, but reading the facing bits directly. A neighbor
+    // with a lower index has been walked already, which is what the status bit 2 marks above.
+    PolyNeighbor *neighbors = mesh->Get_Poly_Neighbor(0);
+
+    if (neighbors == nullptr) {
+        m_numIndicesPerMesh[mesh_index] = 0;
+        return;
+    }
+
+    for (int poly_index = 0; poly_index < num_polys; poly_index++) {
+        PolyNeighbor *us = &neighbors[poly_index];
+        bool us_facing = ShadowFacingBatchClass::Is_Facing(facing, poly_index);
+        bool visible_neighborless = false;
+
+        for (int i = 0; i < 3; i++) {
+            int neighbor_index = us->neighbor[i].neighborIndex;
+
+            if (neighbor_index == -1) {
+                visible_neighborless |= us_facing;
+            } else if (neighbor_index > poly_index
+                && ShadowFacingBatchClass::Is_Facing(facing, neighbor_index) != us_facing) {
+                PolyNeighbor *neighbor = &neighbors[neighbor_index];
 
+                if (us_facing) {
+                    Add_Silhouette_Edge(mesh_index, us, neighbor);
+                } else {
+                    Add_Silhouette_Edge(mesh_index, neighbor, us);
+                }
+            }
+        }
+
+        if (visible_neighborless) {
+            Add_Neighborless_Edges(mesh_index, us);
+        }
+    }
+
+    cache.Add(facing,
+        word_count,
+        &m_silhouetteIndex[mesh_index][mesh_edge_start],
+        m_numSilhouetteIndices[mesh_index] - mesh_edge_start);
+#endif
     m_numIndicesPerMesh[mesh_index] = m_numSilhouetteIndices[mesh_index] - mesh_edge_start;
 }
 
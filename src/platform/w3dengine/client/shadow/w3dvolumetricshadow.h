@@ -26,6 +26,7 @@
 #include "vector3i.h"
 #include "w3dbuffermanager.h"
 #include "w3dshadow.h"
+#include "w3dshadowfacing.h"
 #include <new>
 #ifdef BUILD_WITH_D3D8
 #include "dx8wrapper.h"
@@ -91,6 +92,11 @@ public:
     Vector3 *Get_Vertex(int index) const { return &m_verts[index]; }
     int Get_Num_Vertex() const { return m_numVerts; }
 
+#ifndef GAME_DLL
+    const uint32_t *Classify_Facing(const Vector3 &light_pos);
+    ShadowSilhouetteCacheClass &Get_Silhouette_Cache() { return m_silhouetteCache; }
+#endif
+
 #ifdef GAME_DLL
     W3DShadowGeometryMesh *Hook_Ctor() { return new (this) W3DShadowGeometryMesh(); }
 #endif
@@ -107,6 +113,12 @@ private:
     PolyNeighbor *m_polyNeighbors;
     int m_numPolyNeighbors;
     W3DShadowGeometry *m_parentGeometry;
+#ifndef GAME_DLL
+    ShadowFacingBatchClass m_facingBatch;
+    ShadowSilhouetteCacheClass m_silhouetteCache;
+    std::vector<uint32_t> m_facing;
+    Vector3 m_facingLightPos;
+#endif
     friend class W3DVolumetricShadow;
     friend W3DShadowGeometry;
 };
@@ -21,6 +21,7 @@
 #include "dx8caps.h"
 #include "dx8renderer.h"
 #include "dx8wrapper.h"
+#include "frustumcull.h"
 #include "gamelogic.h"
 #include "globaldata.h"
 #include "light.h"
@@ -36,9 +37,13 @@
 #include "w3dshadow.h"
 #include "w3dshroud.h"
 #include "w3dstatuscircle.h"
+#include <vector>
 
 ShaderClass g_playerColorShader(0x84417);
 
+static FrustumCullBatchClass s_visibilityCullBatch;
+static std::vector<RenderObjClass *> s_visibilityCullObjects;
+
 RTS3DScene::RTS3DScene() : m_drawTerrainOnly(false), m_numGlobalLights(0)
 {
     Set_Name("RTS3DScene");
@@ -261,6 +266,11 @@ void RTS3DScene::Visibility_Check(CameraClass *camera)
     }
 
     if (!ShaderClass::Is_Backface_Culling_Inverted()) {
+        // The spheres of everything that needs a frustum test are gathered first and culled together, so the drawable
+        // and occlusion checks below only ever touch objects that survived.
+        s_visibilityCullBatch.Reset();
+        s_visibilityCullObjects.clear();
+
         for (iter.First(); !iter.Is_Done(); iter.Next()) {
             RenderObjClass *robj = iter.Peek_Obj();
 
@@ -274,7 +284,15 @@ void RTS3DScene::Visibility_Check(CameraClass *camera)
                 continue;
             }
 
-            bool cull = camera->Cull_Sphere(robj->Get_Bounding_Sphere());
+            s_visibilityCullBatch.Add_Sphere(robj->Get_Bounding_Sphere());
+            s_visibilityCullObjects.push_back(robj);
+        }
+
+        const uint8_t *culled = s_visibilityCullBatch.Cull(camera->Get_Frustum());
+
+        for (size_t i = 0; i < s_visibilityCullObjects.size(); ++i) {
+            RenderObjClass *robj = s_visibilityCullObjects[i];
+            bool cull = culled[i] != 0;
             bool visible = !cull;
 
             if (cull) {
@@ -188,6 +188,9 @@ void W3DTerrainVisual::Xfer_Snapshot(Xfer *xfer)
         xfer->xferUser(data, min_size);
 
         if (xfer->Get_Mode() == XFER_LOAD) {
+#ifndef GAME_DLL
+            m_heightMap->Height_Data_Changed();
+#endif
             m_baseHeightMap->Static_Lighting_Changed();
         }
     }
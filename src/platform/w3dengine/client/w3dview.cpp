@@ -22,6 +22,7 @@
 #include "drawable.h"
 #include "drawmodule.h"
 #include "dx8renderer.h"
+#include "gameclient.h"
 #include "gamewindowmanager.h"
 #include "globaldata.h"
 #include "ingameui.h"
@@ -413,6 +414,100 @@ Drawable *W3DView::Pick_Drawable(const ICoord2D *screen, bool force_attack, Pick
     return drawable;
 }
 
+#ifndef GAME_DLL
+static void Add_To_Footprint(Region2D &footprint, bool &found, const Vector3 &point)
+{
+    if (!found) {
+        footprint.lo.x = point.X;
+        footprint.lo.y = point.Y;
+        footprint.hi.x = point.X;
+        footprint.hi.y = point.Y;
+        found = true;
+    } else {
+        footprint.lo.x = std::min(footprint.lo.x, point.X);
+        footprint.lo.y = std::min(footprint.lo.y, point.Y);
+        footprint.hi.x = std::max(footprint.hi.x, point.X);
+        footprint.hi.y = std::max(footprint.hi.y, point.Y);
+    }
+}
+
+// Bounds the world XY of every point between min_z and max_z that the camera projects inside both the frustum and the
+// normalized screen region. The part of the frustum behind the region is cut down to those heights and everything is
+// padded a little, so rounding in the projection can never put a point outside of the footprint.
+static bool Get_Screen_Region_Footprint(
+    CameraClass *camera, const Region2D &region, float min_z, float max_z, Region2D &footprint)
+{
+    static const int edges[12][2] = {
+        { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 }, { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }
+    };
+    const float screen_pad = 0.001f;
+    const float world_pad = 1.0f;
+
+    if (camera->Get_Projection_Type() != CameraClass::PERSPECTIVE) {
+        return false;
+    }
+
+    float lo_x = std::max(region.lo.x, -1.0f) - screen_pad;
+    float lo_y = std::max(region.lo.y, -1.0f) - screen_pad;
+    float hi_x = std::min(region.hi.x, 1.0f) + screen_pad;
+    float hi_y = std::min(region.hi.y, 1.0f) + screen_pad;
+
+    if (lo_x > hi_x || lo_y > hi_y) {
+        return false;
+    }
+
+    float znear;
+    float zfar;
+    camera->Get_Clip_Planes(znear, zfar);
+    Vector3 eye = camera->Get_Position();
+    Vector3 corners[8];
+    const float corner_x[4] = { lo_x, hi_x, hi_x, lo_x };
+    const float corner_y[4] = { lo_y, lo_y, hi_y, hi_y };
+
+    // Un_Project gives the point one unit in front of the camera, so scaling its offset from the eye gives any depth.
+    for (int i = 0; i < 4; ++i) {
+        Vector3 dir;
+        camera->Un_Project(dir, Vector2(corner_x[i], corner_y[i]));
+        dir -= eye;
+        corners[i] = eye + dir * (znear * 0.99f);
+        corners[i + 4] = eye + dir * (zfar * 1.01f);
+    }
+
+    float lo_z = min_z - world_pad;
+    float hi_z = max_z + world_pad;
+    bool found = false;
+
+    for (int i = 0; i < 8; ++i) {
+        if (corners[i].Z >= lo_z && corners[i].Z <= hi_z) {
+            Add_To_Footprint(footprint, found, corners[i]);
+        }
+    }
+
+    for (int i = 0; i < 12; ++i) {
+        const Vector3 &a = corners[edges[i][0]];
+        const Vector3 &b = corners[edges[i][1]];
+
+        for (int j = 0; j < 2; ++j) {
+            float z = j == 0 ? lo_z : hi_z;
+
+            if ((a.Z - z) * (b.Z - z) < 0.0f) {
+                Add_To_Footprint(footprint, found, a + (b - a) * ((z - a.Z) / (b.Z - a.Z)));
+            }
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    footprint.lo.x -= world_pad;
+    footprint.lo.y -= world_pad;
+    footprint.hi.x += world_pad;
+    footprint.hi.y += world_pad;
+    return true;
+}
+#endif
+
 int W3DView::Iterate_Drawables_In_Region(IRegion2D *screen_region, bool (*callback)(Drawable *, void *), void *user_data)
 {
     int count = 0;
@@ -454,6 +549,39 @@ int W3DView::Iterate_Drawables_In_Region(IRegion2D *screen_region, bool (*callba
         }
     }
 
+#ifndef GAME_DLL
+    // Only drawables under the part of the world the region looks at can pass, the grid hands those over in list order.
+    if (screen_region != nullptr && drawable == nullptr) {
+        DrawableGridClass &grid = g_theGameClient->Get_Drawable_Grid();
+        Region2D footprint;
+        float min_z;
+        float max_z;
+
+        if (grid.Get_Height_Range(min_z, max_z)
+            && Get_Screen_Region_Footprint(m_3DCamera, normalized_region, min_z, max_z, footprint)) {
+            std::vector<Drawable *> drawables;
+            grid.Collect(footprint, drawables);
+
+            for (Drawable *draw : drawables) {
+                const Coord3D *pos = draw->Get_Position();
+                world.X = pos->x;
+                world.Y = pos->y;
+                world.Z = pos->z;
+
+                if (m_3DCamera->Project(screen, world) == CameraClass::INSIDE_FRUSTUM && screen.X >= normalized_region.lo.x
+                    && screen.X <= normalized_region.hi.x && screen.Y >= normalized_region.lo.y
+                    && screen.Y <= normalized_region.hi.y) {
+                    if (callback(draw, user_data)) {
+                        count++;
+                    }
+                }
+            }
+
+            return count;
+        }
+    }
+#endif
+
     for (Drawable *draw = g_theGameClient->First_Drawable(); draw != nullptr; draw = draw->Get_Next()) {
         bool do_callback;
 
@@ -72,6 +72,10 @@ WorldHeightMap::WorldHeightMap() :
     m_drawOriginY(0),
     m_drawWidthX(129),
     m_drawHeightY(129)
+#ifndef GAME_DLL
+    ,
+    m_heightPyramid(nullptr)
+#endif
 {
     for (int i = 0; i < TILE_COUNT; i++) {
         m_sourceTiles[i] = nullptr;
@@ -107,6 +111,10 @@ WorldHeightMap::WorldHeightMap(ChunkInputStream *strm, bool logical_data_only) :
     m_drawOriginY(0),
     m_drawWidthX(129),
     m_drawHeightY(129)
+#ifndef GAME_DLL
+    ,
+    m_heightPyramid(nullptr)
+#endif
 {
     for (int i = 0; i < TILE_COUNT; i++) {
         m_sourceTiles[i] = nullptr;
@@ -174,10 +182,18 @@ WorldHeightMap::WorldHeightMap(ChunkInputStream *strm, bool logical_data_only) :
 
     g_theSidesList->Validate_Sides();
     Setup_Alpha_Tiles();
+#ifndef GAME_DLL
+    Height_Data_Changed();
+#endif
 }
 
 WorldHeightMap::~WorldHeightMap()
 {
+#ifndef GAME_DLL
+    delete m_heightPyramid;
+    m_heightPyramid = nullptr;
+#endif
+
     if (m_data) {
         delete[] m_data;
         m_data = nullptr;
@@ -236,6 +252,26 @@ WorldHeightMap::~WorldHeightMap()
     Ref_Ptr_Release(m_alphaTerrainTex);
 }
 
+#ifndef GAME_DLL
+/**
+ * @brief Rebuilds the height pyramid, needed after the height data was written to other than through Set_Height.
+ */
+void WorldHeightMap::Height_Data_Changed()
+{
+    if (m_data == nullptr) {
+        delete m_heightPyramid;
+        m_heightPyramid = nullptr;
+        return;
+    }
+
+    if (m_heightPyramid == nullptr) {
+        m_heightPyramid = new HeightPyramidClass();
+    }
+
+    m_heightPyramid->Build(m_data, m_width, m_height);
+}
+#endif
+
 void WorldHeightMap::Free_List_Of_Map_Objects()
 {
     if (MapObject::s_theMapObjectListPtr) {
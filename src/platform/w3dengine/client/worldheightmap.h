@@ -17,6 +17,7 @@
 #include "always.h"
 #include "asciistring.h"
 #include "coord.h"
+#include "heightpyramid.h"
 #include "refcount.h"
 #include "tiledata.h"
 #include <vector>
@@ -144,6 +145,10 @@ public:
     int Get_Draw_Origin_X() { return m_drawOriginX; }
     int Get_Draw_Origin_Y() { return m_drawOriginY; }
     unsigned char *Get_Data_Ptr() { return m_data; }
+#ifndef GAME_DLL
+    const HeightPyramidClass *Get_Height_Pyramid() const { return m_heightPyramid; }
+    void Height_Data_Changed();
+#endif
 
     void Set_Draw_Width(int width)
     {
@@ -189,6 +194,11 @@ public:
 
         if (i >= 0 && i < m_dataSize && m_data != nullptr) {
             m_data[i] = height;
+#ifndef GAME_DLL
+            if (m_heightPyramid != nullptr) {
+                m_heightPyramid->Update(x, y);
+            }
+#endif
         }
     }
 
@@ -300,6 +310,9 @@ protected:
     int m_drawOriginY;
     int m_drawWidthX;
     int m_drawHeightY;
+#ifndef GAME_DLL
+    HeightPyramidClass *m_heightPyramid;
+#endif
     friend class W3DTreeBuffer;
     friend class W3DTerrainLogic;
 };
@@ -43,6 +43,21 @@ using std::strncpy;
 
 namespace
 {
+// Reads the extended control register telling which register states the OS saves.
+uint64_t Get_XCR0()
+{
+#if defined _MSC_VER && (defined PROCESSOR_X86 || defined PROCESSOR_X86_64)
+    return _xgetbv(0);
+#elif (defined __GNUC__ || defined __clang__) && (defined PROCESSOR_X86 || defined PROCESSOR_X86_64)
+    uint32_t eax;
+    uint32_t edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#else
+    return 0;
+#endif
+}
+
 struct OSInfoStruct
 {
     const char *Code;
@@ -333,6 +348,7 @@ bool CPUDetectClass::HasCPUIDInstruction = false;
 bool CPUDetectClass::HasRDTSCInstruction = false;
 bool CPUDetectClass::HasSSESupport = false;
 bool CPUDetectClass::HasSSE2Support = false;
+bool CPUDetectClass::HasAVX2Support = false;
 bool CPUDetectClass::HasCMOVSupport = false;
 bool CPUDetectClass::HasMMXSupport = false;
 bool CPUDetectClass::Has3DNowSupport = false;
@@ -1284,6 +1300,20 @@ void CPUDetectClass::Init_Processor_Features()
     Has3DNowSupport = false;
     ExtendedFeatureBits = 0;
 
+    // AVX2 also needs the OS to save the upper halves of the YMM registers on a context switch.
+    bool has_osxsave = !!(id.ecx & (1 << 27));
+    bool has_avx = !!(id.ecx & (1 << 28));
+    HasAVX2Support = false;
+
+    if (has_osxsave && has_avx && (Get_XCR0() & 6) == 6) {
+        CPUIDStruct max_id(0);
+
+        if (max_id.eax >= 7) {
+            CPUIDCountStruct ext_id(7, 0);
+            HasAVX2Support = !!(ext_id.ebx & (1 << 5));
+        }
+    }
+
     if (ProcessorManufacturer == MANUFACTURER_AMD) {
         if (Has_CPUID_Instruction()) {
             CPUIDStruct max_ext_id(0x80000000);
@@ -1421,7 +1451,7 @@ bool CPUDetectClass::CPUID_Count(
 
     int32_t regs[4] = { 0 };
 
-#ifdef HAVE__CPUIDEX
+#if defined HAVE__CPUIDEX || defined HAVE_CPUIDEX
     __cpuidex(regs, cpuid_type, count);
 #endif
 
@@ -1513,6 +1543,7 @@ void CPUDetectClass::Init_Processor_Log()
     CPU_LOG("MMX: %s\n", CPUDetectClass::Has_MMX_Instruction_Set() ? "Yes" : "No");
     CPU_LOG("SSE: %s\n", CPUDetectClass::Has_SSE_Instruction_Set() ? "Yes" : "No");
     CPU_LOG("SSE2: %s\n", CPUDetectClass::Has_SSE2_Instruction_Set() ? "Yes" : "No");
+    CPU_LOG("AVX2: %s\n", CPUDetectClass::Has_AVX2_Instruction_Set() ? "Yes" : "No");
     CPU_LOG("3DNow!: %s\n", CPUDetectClass::Has_3DNow_Instruction_Set() ? "Yes" : "No");
     CPU_LOG("Extended 3DNow!: %s\n", CPUDetectClass::Has_Extended_3DNow_Instruction_Set() ? "Yes" : "No");
     CPU_LOG("CPU Feature bits: 0x%x\n", CPUDetectClass::Get_Feature_Bits());
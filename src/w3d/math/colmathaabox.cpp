@@ -14,6 +14,7 @@
  */
 #include "aabox.h"
 #include "colmath.h"
+#include "sphere.h"
 #include <algorithm>
 CollisionMath::OverlapType CollisionMath::Overlap_Test(const AABoxClass &box, const Vector3 &point)
 {
@@ -66,6 +67,22 @@ bool CollisionMath::Intersection_Test(const AABoxClass &box, const AABoxClass &b
         && ((box.m_extent.Z + box2.m_extent.Z) >= GameMath::Fabs(dc.Z));
 }
 
+bool CollisionMath::Intersection_Test(const SphereClass &sphere, const AABoxClass &box)
+{
+    // Squared distance from the center of the sphere to the closest point of the box.
+    float dist2 = 0.0f;
+
+    for (int i = 0; i < 3; ++i) {
+        float d = GameMath::Fabs(sphere.Center[i] - box.m_center[i]) - box.m_extent[i];
+
+        if (d > 0.0f) {
+            dist2 += d * d;
+        }
+    }
+
+    return dist2 <= sphere.Radius * sphere.Radius;
+}
+
 CollisionMath::OverlapType CollisionMath::Overlap_Test(const AABoxClass &box, const LineSegClass &line)
 {
     int count = 0;
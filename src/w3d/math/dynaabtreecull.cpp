@@ -0,0 +1,532 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Culling system keeping its objects in a dynamic bounding box tree.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include "dynaabtreecull.h"
+#include "colmath.h"
+#include "frustum.h"
+#include "obbox.h"
+#include "sphere.h"
+#include <algorithm>
+
+enum
+{
+    ALL_FRUSTUM_PLANES = 0x3F,
+    INITIAL_NODE_CAPACITY = 16,
+};
+
+static const float VALIDATE_SLOP = 0.001f;
+
+namespace
+{
+float Surface_Area(const AABoxClass &box)
+{
+    // Half the real area, only ever compared against other areas.
+    return box.m_extent.X * box.m_extent.Y + box.m_extent.Y * box.m_extent.Z + box.m_extent.Z * box.m_extent.X;
+}
+
+AABoxClass Merge(const AABoxClass &a, const AABoxClass &b)
+{
+    AABoxClass box(a);
+    box.Add_Box(b);
+    return box;
+}
+
+bool Box_Contains(const AABoxClass &box, const AABoxClass &inner, float slop = 0.0f)
+{
+    Vector3 dc = inner.m_center - box.m_center;
+    return GameMath::Fabs(dc.X) + inner.m_extent.X <= box.m_extent.X + slop
+        && GameMath::Fabs(dc.Y) + inner.m_extent.Y <= box.m_extent.Y + slop
+        && GameMath::Fabs(dc.Z) + inner.m_extent.Z <= box.m_extent.Z + slop;
+}
+
+struct PointQueryStruct
+{
+    PointQueryStruct(const Vector3 &point) : m_point(point) {}
+    bool Test(const AABoxClass &box) const { return CollisionMath::Overlap_Test(box, m_point) != CollisionMath::POS; }
+    const Vector3 &m_point;
+};
+
+struct AABoxQueryStruct
+{
+    AABoxQueryStruct(const AABoxClass &box) : m_box(box) {}
+    bool Test(const AABoxClass &box) const { return CollisionMath::Intersection_Test(m_box, box); }
+    const AABoxClass &m_box;
+};
+
+struct OBBoxQueryStruct
+{
+    OBBoxQueryStruct(const OBBoxClass &box) : m_box(box) {}
+    bool Test(const AABoxClass &box) const { return CollisionMath::Intersection_Test(m_box, box); }
+    const OBBoxClass &m_box;
+};
+
+struct SphereQueryStruct
+{
+    SphereQueryStruct(const SphereClass &sphere) : m_sphere(sphere) {}
+    bool Test(const AABoxClass &box) const { return CollisionMath::Intersection_Test(m_sphere, box); }
+    const SphereClass &m_sphere;
+};
+} // namespace
+
+DynamicAABTreeCullSystemClass::DynamicAABTreeCullSystemClass() :
+    m_nodes(nullptr),
+    m_stack(nullptr),
+    m_stackPlanes(nullptr),
+    m_nodeCapacity(0),
+    m_freeList(-1),
+    m_root(-1),
+    m_objectCount(0),
+    m_margin(1.0f)
+{
+}
+
+DynamicAABTreeCullSystemClass::~DynamicAABTreeCullSystemClass()
+{
+    Remove_All_Internal();
+    delete[] m_nodes;
+    delete[] m_stack;
+    delete[] m_stackPlanes;
+}
+
+void DynamicAABTreeCullSystemClass::Add_Object_Internal(CullableClass *obj)
+{
+    captainslog_assert(obj != nullptr);
+    captainslog_assert(obj->Get_Cull_Link() == nullptr);
+
+    DynamicAABTreeLinkClass *link = new DynamicAABTreeLinkClass(this);
+    obj->Set_Cull_Link(link);
+    obj->Add_Ref();
+
+    int leaf = Allocate_Node();
+    NodeStruct &node = m_nodes[leaf];
+    node.m_box = obj->Get_Cull_Box();
+    node.m_box.m_extent += Vector3(m_margin, m_margin, m_margin);
+    node.m_object = obj;
+    node.m_height = 0;
+    Insert_Leaf(leaf);
+
+    link->m_node = leaf;
+    ++m_objectCount;
+}
+
+void DynamicAABTreeCullSystemClass::Remove_Object_Internal(CullableClass *obj)
+{
+    captainslog_assert(obj != nullptr);
+    DynamicAABTreeLinkClass *link = static_cast<DynamicAABTreeLinkClass *>(obj->Get_Cull_Link());
+
+    if (link == nullptr || link->Get_Culling_System() != this) {
+        return;
+    }
+
+    Remove_Leaf(link->m_node);
+    Free_Node(link->m_node);
+
+    link->Set_Culling_System(nullptr);
+    delete link;
+    obj->Set_Cull_Link(nullptr);
+    obj->Release_Ref();
+    --m_objectCount;
+}
+
+void DynamicAABTreeCullSystemClass::Remove_All_Internal()
+{
+    m_freeList = -1;
+
+    for (int i = m_nodeCapacity - 1; i >= 0; --i) {
+        NodeStruct &node = m_nodes[i];
+
+        if (node.m_height == 0) {
+            CullableClass *obj = node.m_object;
+            CullLinkClass *link = obj->Get_Cull_Link();
+            link->Set_Culling_System(nullptr);
+            delete link;
+            obj->Set_Cull_Link(nullptr);
+            obj->Release_Ref();
+        }
+
+        node.m_height = -1;
+        node.m_object = nullptr;
+        node.m_parent = m_freeList;
+        m_freeList = i;
+    }
+
+    m_root = -1;
+    m_objectCount = 0;
+}
+
+/**
+ * @brief Moves the leaf of an object whose cull box no longer fits in the grown box the leaf was given.
+ */
+void DynamicAABTreeCullSystemClass::Update_Culling(CullableClass *obj)
+{
+    captainslog_assert(obj != nullptr);
+    DynamicAABTreeLinkClass *link = static_cast<DynamicAABTreeLinkClass *>(obj->Get_Cull_Link());
+    captainslog_assert(link != nullptr && link->Get_Culling_System() == this);
+    int leaf = link->m_node;
+    const AABoxClass &box = obj->Get_Cull_Box();
+
+    if (Box_Contains(m_nodes[leaf].m_box, box)) {
+        return;
+    }
+
+    Remove_Leaf(leaf);
+    m_nodes[leaf].m_box = box;
+    m_nodes[leaf].m_box.m_extent += Vector3(m_margin, m_margin, m_margin);
+    Insert_Leaf(leaf);
+}
+
+int DynamicAABTreeCullSystemClass::Allocate_Node()
+{
+    if (m_freeList == -1) {
+        int capacity = m_nodeCapacity != 0 ? m_nodeCapacity * 2 : INITIAL_NODE_CAPACITY;
+        NodeStruct *nodes = new NodeStruct[capacity];
+
+        for (int i = 0; i < m_nodeCapacity; ++i) {
+            nodes[i] = m_nodes[i];
+        }
+
+        for (int i = capacity - 1; i >= m_nodeCapacity; --i) {
+            nodes[i].m_object = nullptr;
+            nodes[i].m_height = -1;
+            nodes[i].m_parent = m_freeList;
+            m_freeList = i;
+        }
+
+        delete[] m_nodes;
+        delete[] m_stack;
+        delete[] m_stackPlanes;
+        m_nodes = nodes;
+
+        // A walk never holds more entries than the tree has nodes.
+        m_stack = new int[capacity];
+        m_stackPlanes = new int[capacity];
+        m_nodeCapacity = capacity;
+    }
+
+    int index = m_freeList;
+    NodeStruct &node = m_nodes[index];
+    m_freeList = node.m_parent;
+    node.m_parent = -1;
+    node.m_child[0] = -1;
+    node.m_child[1] = -1;
+    node.m_height = 0;
+    node.m_object = nullptr;
+
+    return index;
+}
+
+void DynamicAABTreeCullSystemClass::Free_Node(int index)
+{
+    NodeStruct &node = m_nodes[index];
+    node.m_height = -1;
+    node.m_object = nullptr;
+    node.m_parent = m_freeList;
+    m_freeList = index;
+}
+
+/**
+ * @brief Finds the sibling that grows the tree the least and pairs the leaf with it under a new node.
+ */
+void DynamicAABTreeCullSystemClass::Insert_Leaf(int leaf)
+{
+    if (m_root == -1) {
+        m_root = leaf;
+        m_nodes[leaf].m_parent = -1;
+        return;
+    }
+
+    AABoxClass leaf_box = m_nodes[leaf].m_box;
+    int index = m_root;
+
+    while (!m_nodes[index].Is_Leaf()) {
+        const NodeStruct &node = m_nodes[index];
+        float area = Surface_Area(node.m_box);
+        float combined_area = Surface_Area(Merge(node.m_box, leaf_box));
+
+        // Cost of pairing the leaf with this node, and the growth every node below here pays on top.
+        float cost = 2.0f * combined_area;
+        float inheritance = 2.0f * (combined_area - area);
+        float child_cost[2];
+
+        for (int i = 0; i < 2; ++i) {
+            const NodeStruct &child = m_nodes[node.m_child[i]];
+            child_cost[i] = Surface_Area(Merge(child.m_box, leaf_box)) + inheritance;
+
+            if (!child.Is_Leaf()) {
+                child_cost[i] -= Surface_Area(child.m_box);
+            }
+        }
+
+        if (cost < child_cost[0] && cost < child_cost[1]) {
+            break;
+        }
+
+        index = child_cost[0] < child_cost[1] ? node.m_child[0] : node.m_child[1];
+    }
+
+    int sibling = index;
+    int old_parent = m_nodes[sibling].m_parent;
+    int parent = Allocate_Node();
+    NodeStruct &parent_node = m_nodes[parent];
+    parent_node.m_parent = old_parent;
+    parent_node.m_box = Merge(leaf_box, m_nodes[sibling].m_box);
+    parent_node.m_height = m_nodes[sibling].m_height + 1;
+    parent_node.m_child[0] = sibling;
+    parent_node.m_child[1] = leaf;
+    m_nodes[sibling].m_parent = parent;
+    m_nodes[leaf].m_parent = parent;
+
+    if (old_parent == -1) {
+        m_root = parent;
+    } else if (m_nodes[old_parent].m_child[0] == sibling) {
+        m_nodes[old_parent].m_child[0] = parent;
+    } else {
+        m_nodes[old_parent].m_child[1] = parent;
+    }
+
+    Refit(old_parent);
+}
+
+/**
+ * @brief Unlinks a leaf from the tree, its parent goes away and the sibling takes its place.
+ */
+void DynamicAABTreeCullSystemClass::Remove_Leaf(int leaf)
+{
+    if (leaf == m_root) {
+        m_root = -1;
+        return;
+    }
+
+    int parent = m_nodes[leaf].m_parent;
+    int grand_parent = m_nodes[parent].m_parent;
+    int sibling = m_nodes[parent].m_child[0] == leaf ? m_nodes[parent].m_child[1] : m_nodes[parent].m_child[0];
+    Free_Node(parent);
+
+    if (grand_parent == -1) {
+        m_root = sibling;
+        m_nodes[sibling].m_parent = -1;
+        return;
+    }
+
+    if (m_nodes[grand_parent].m_child[0] == parent) {
+        m_nodes[grand_parent].m_child[0] = sibling;
+    } else {
+        m_nodes[grand_parent].m_child[1] = sibling;
+    }
+
+    m_nodes[sibling].m_parent = grand_parent;
+    Refit(grand_parent);
+}
+
+/**
+ * @brief Rebalances and recomputes the boxes and heights from a node up to the root.
+ */
+void DynamicAABTreeCullSystemClass::Refit(int index)
+{
+    while (index != -1) {
+        index = Balance(index);
+        NodeStruct &node = m_nodes[index];
+        const NodeStruct &child0 = m_nodes[node.m_child[0]];
+        const NodeStruct &child1 = m_nodes[node.m_child[1]];
+        node.m_box = Merge(child0.m_box, child1.m_box);
+        node.m_height = std::max(child0.m_height, child1.m_height) + 1;
+        index = node.m_parent;
+    }
+}
+
+/**
+ * @brief Rotates the taller child of a node above it when the heights of its children differ by more than one,
+ * returning the node now standing where it was.
+ */
+int DynamicAABTreeCullSystemClass::Balance(int index)
+{
+    NodeStruct &a = m_nodes[index];
+
+    if (a.Is_Leaf() || a.m_height < 2) {
+        return index;
+    }
+
+    int balance = m_nodes[a.m_child[1]].m_height - m_nodes[a.m_child[0]].m_height;
+
+    if (balance >= -1 && balance <= 1) {
+        return index;
+    }
+
+    // The taller child moves up, keeping its own taller child and handing the shorter one down to the old node.
+    int side = balance > 1 ? 1 : 0;
+    int up = a.m_child[side];
+    NodeStruct &b = m_nodes[up];
+    int keep = b.m_child[0];
+    int give = b.m_child[1];
+
+    if (m_nodes[keep].m_height < m_nodes[give].m_height) {
+        std::swap(keep, give);
+    }
+
+    b.m_child[0] = index;
+    b.m_child[1] = keep;
+    b.m_parent = a.m_parent;
+    a.m_parent = up;
+
+    if (b.m_parent == -1) {
+        m_root = up;
+    } else if (m_nodes[b.m_parent].m_child[0] == index) {
+        m_nodes[b.m_parent].m_child[0] = up;
+    } else {
+        m_nodes[b.m_parent].m_child[1] = up;
+    }
+
+    a.m_child[side] = give;
+    m_nodes[give].m_parent = index;
+
+    const NodeStruct &other = m_nodes[a.m_child[1 - side]];
+    a.m_box = Merge(other.m_box, m_nodes[give].m_box);
+    a.m_height = std::max(other.m_height, m_nodes[give].m_height) + 1;
+    b.m_box = Merge(a.m_box, m_nodes[keep].m_box);
+    b.m_height = std::max(a.m_height, m_nodes[keep].m_height) + 1;
+
+    return up;
+}
+
+template<class QueryType> void DynamicAABTreeCullSystemClass::Collect(const QueryType &query)
+{
+    if (m_root == -1) {
+        return;
+    }
+
+    int top = 0;
+    m_stack[top++] = m_root;
+
+    while (top > 0) {
+        const NodeStruct &node = m_nodes[m_stack[--top]];
+
+        if (!query.Test(node.m_box)) {
+            continue;
+        }
+
+        if (node.Is_Leaf()) {
+            if (query.Test(node.m_object->Get_Cull_Box())) {
+                Add_To_Collection(node.m_object);
+            }
+        } else {
+            m_stack[top++] = node.m_child[0];
+            m_stack[top++] = node.m_child[1];
+        }
+    }
+}
+
+void DynamicAABTreeCullSystemClass::Collect_Objects(const Vector3 &point)
+{
+    Collect(PointQueryStruct(point));
+}
+
+void DynamicAABTreeCullSystemClass::Collect_Objects(const AABoxClass &box)
+{
+    Collect(AABoxQueryStruct(box));
+}
+
+void DynamicAABTreeCullSystemClass::Collect_Objects(const OBBoxClass &box)
+{
+    Collect(OBBoxQueryStruct(box));
+}
+
+void DynamicAABTreeCullSystemClass::Collect_Objects(const SphereClass &sphere)
+{
+    Collect(SphereQueryStruct(sphere));
+}
+
+void DynamicAABTreeCullSystemClass::Collect_Objects(const FrustumClass &frustum)
+{
+    if (m_root == -1) {
+        return;
+    }
+
+    int top = 0;
+    m_stack[top] = m_root;
+    m_stackPlanes[top++] = 0;
+
+    while (top > 0) {
+        --top;
+        const NodeStruct &node = m_nodes[m_stack[top]];
+        int planes = m_stackPlanes[top];
+
+        if (planes != ALL_FRUSTUM_PLANES
+            && CollisionMath::Overlap_Test(frustum, node.m_box, planes) == CollisionMath::OUTSIDE) {
+            continue;
+        }
+
+        if (node.Is_Leaf()) {
+            // Everything inside a node that passed all the planes is inside the frustum as well.
+            if (planes == ALL_FRUSTUM_PLANES
+                || CollisionMath::Overlap_Test(frustum, node.m_object->Get_Cull_Box(), planes) != CollisionMath::OUTSIDE) {
+                Add_To_Collection(node.m_object);
+            }
+        } else {
+            m_stack[top] = node.m_child[0];
+            m_stackPlanes[top++] = planes;
+            m_stack[top] = node.m_child[1];
+            m_stackPlanes[top++] = planes;
+        }
+    }
+}
+
+int DynamicAABTreeCullSystemClass::Get_Height() const
+{
+    return m_root != -1 ? m_nodes[m_root].m_height : 0;
+}
+
+/**
+ * @brief Checks the links, heights and boxes of the whole tree, returning false at the first thing found wrong.
+ */
+bool DynamicAABTreeCullSystemClass::Validate() const
+{
+    if (m_root == -1) {
+        return m_objectCount == 0;
+    }
+
+    int height;
+    int leaves = 0;
+
+    return Validate_Node(m_root, -1, height, leaves) && leaves == m_objectCount;
+}
+
+bool DynamicAABTreeCullSystemClass::Validate_Node(int index, int parent, int &height, int &leaves) const
+{
+    const NodeStruct &node = m_nodes[index];
+
+    if (node.m_parent != parent || node.m_height < 0) {
+        return false;
+    }
+
+    if (node.Is_Leaf()) {
+        height = 0;
+        ++leaves;
+        return node.m_object != nullptr && node.m_height == 0 && Box_Contains(node.m_box, node.m_object->Get_Cull_Box());
+    }
+
+    int height0;
+    int height1;
+
+    if (!Validate_Node(node.m_child[0], index, height0, leaves)
+        || !Validate_Node(node.m_child[1], index, height1, leaves)) {
+        return false;
+    }
+
+    height = std::max(height0, height1) + 1;
+
+    // Merged boxes are stored as center and extent, which can round a hair inside the corners they came from.
+    return node.m_height == height
+        && Box_Contains(node.m_box, m_nodes[node.m_child[0]].m_box, VALIDATE_SLOP)
+        && Box_Contains(node.m_box, m_nodes[node.m_child[1]].m_box, VALIDATE_SLOP);
+}
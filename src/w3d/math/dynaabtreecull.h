@@ -0,0 +1,102 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Culling system keeping its objects in a dynamic bounding box tree.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#pragma once
+
+#include "always.h"
+#include "cullsys.h"
+
+class SphereClass;
+
+// Each object gets a leaf whose box is its cull box grown by a margin, and leaves are paired up under internal nodes
+// chosen to keep the summed surface area of the tree low, with rotations keeping it balanced as objects come and go.
+// When Set_Cull_Box moves an object its leaf is only taken out and reinserted once the new cull box leaves the grown
+// one, so objects jittering in place cost nothing. Queries walk the tree and only test the real cull box of the objects
+// whose leaves they reach, so the objects collected are exactly those a test against every cull box would find. A
+// frustum query remembers the planes a node lies completely inside of and stops testing them below it.
+class DynamicAABTreeCullSystemClass : public CullSystemClass
+{
+public:
+    DynamicAABTreeCullSystemClass();
+    virtual ~DynamicAABTreeCullSystemClass() override;
+
+    virtual void Collect_Objects(const Vector3 &point) override;
+    virtual void Collect_Objects(const AABoxClass &box) override;
+    virtual void Collect_Objects(const OBBoxClass &box) override;
+    virtual void Collect_Objects(const FrustumClass &frustum) override;
+    void Collect_Objects(const SphereClass &sphere);
+    virtual void Update_Culling(CullableClass *obj) override;
+
+    void Set_Margin(float margin) { m_margin = margin; }
+    float Get_Margin() const { return m_margin; }
+    int Get_Object_Count() const { return m_objectCount; }
+    int Get_Height() const;
+    bool Validate() const;
+
+protected:
+    void Add_Object_Internal(CullableClass *obj);
+    void Remove_Object_Internal(CullableClass *obj);
+    void Remove_All_Internal();
+
+private:
+    struct NodeStruct
+    {
+        AABoxClass m_box;
+        CullableClass *m_object;
+        int m_parent; // Next free node while on the free list.
+        int m_child[2];
+        int m_height; // Zero for leaves, -1 for free nodes.
+
+        bool Is_Leaf() const { return m_child[0] == -1; }
+    };
+
+    int Allocate_Node();
+    void Free_Node(int index);
+    void Insert_Leaf(int leaf);
+    void Remove_Leaf(int leaf);
+    int Balance(int index);
+    void Refit(int index);
+    bool Validate_Node(int index, int parent, int &height, int &leaves) const;
+    template<class QueryType> void Collect(const QueryType &query);
+
+    NodeStruct *m_nodes;
+    int *m_stack;
+    int *m_stackPlanes;
+    int m_nodeCapacity;
+    int m_freeList;
+    int m_root;
+    int m_objectCount;
+    float m_margin;
+};
+
+class DynamicAABTreeLinkClass : public CullLinkClass
+{
+public:
+    DynamicAABTreeLinkClass(CullSystemClass *system) : CullLinkClass(system), m_node(-1) {}
+
+    int m_node;
+};
+
+template<class T> class TypedDynamicAABTreeCullSystemClass : public DynamicAABTreeCullSystemClass
+{
+public:
+    void Add_Object(T *obj) { Add_Object_Internal(obj); }
+    void Remove_Object(T *obj) { Remove_Object_Internal(obj); }
+    void Remove_All() { Remove_All_Internal(); }
+
+    T *Get_First_Collected_Object() { return static_cast<T *>(Get_First_Collected_Object_Internal()); }
+    T *Get_Next_Collected_Object(T *obj) { return static_cast<T *>(Get_Next_Collected_Object_Internal(obj)); }
+    T *Peek_First_Collected_Object() { return static_cast<T *>(Peek_First_Collected_Object_Internal()); }
+    T *Peek_Next_Collected_Object(T *obj) { return static_cast<T *>(Peek_Next_Collected_Object_Internal(obj)); }
+};
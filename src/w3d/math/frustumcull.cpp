@@ -0,0 +1,205 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Culls batches of bounding spheres against a view frustum several at a time.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include "frustumcull.h"
+#include "frustum.h"
+#include "sphere.h"
+#include <cstring>
+
+#if defined PROCESSOR_X86 || defined PROCESSOR_X86_64
+#include <xmmintrin.h>
+#define FRUSTUMCULL_SSE
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define FRUSTUMCULL_NEON
+#endif
+
+enum
+{
+    CULL_BATCH_WIDTH = 4,
+    FRUSTUM_PLANE_COUNT = 6,
+};
+
+FrustumCullBatchClass::FrustumCullBatchClass() :
+    m_centerX(nullptr),
+    m_centerY(nullptr),
+    m_centerZ(nullptr),
+    m_radius(nullptr),
+    m_culled(nullptr),
+    m_count(0),
+    m_capacity(0)
+{
+}
+
+FrustumCullBatchClass::~FrustumCullBatchClass()
+{
+    Free();
+}
+
+void FrustumCullBatchClass::Free()
+{
+    delete[] m_centerX;
+    delete[] m_centerY;
+    delete[] m_centerZ;
+    delete[] m_radius;
+    delete[] m_culled;
+    m_centerX = nullptr;
+    m_centerY = nullptr;
+    m_centerZ = nullptr;
+    m_radius = nullptr;
+    m_culled = nullptr;
+    m_count = 0;
+    m_capacity = 0;
+}
+
+void FrustumCullBatchClass::Reserve(int count)
+{
+    if (count <= m_capacity) {
+        return;
+    }
+
+    // Grow geometrically and keep room for a whole trailing batch so the wide loop never needs a scalar tail.
+    int capacity = m_capacity * 2 > count ? m_capacity * 2 : count;
+    capacity = (capacity + CULL_BATCH_WIDTH - 1) & ~(CULL_BATCH_WIDTH - 1);
+
+    float *center_x = new float[capacity];
+    float *center_y = new float[capacity];
+    float *center_z = new float[capacity];
+    float *radius = new float[capacity];
+
+    if (m_count != 0) {
+        memcpy(center_x, m_centerX, m_count * sizeof(float));
+        memcpy(center_y, m_centerY, m_count * sizeof(float));
+        memcpy(center_z, m_centerZ, m_count * sizeof(float));
+        memcpy(radius, m_radius, m_count * sizeof(float));
+    }
+
+    delete[] m_centerX;
+    delete[] m_centerY;
+    delete[] m_centerZ;
+    delete[] m_radius;
+    delete[] m_culled;
+    m_centerX = center_x;
+    m_centerY = center_y;
+    m_centerZ = center_z;
+    m_radius = radius;
+    m_culled = new uint8_t[capacity];
+    m_capacity = capacity;
+}
+
+/**
+ * @brief Adds a sphere to the batch, returning the index its result will have.
+ */
+int FrustumCullBatchClass::Add_Sphere(const SphereClass &sphere)
+{
+    Reserve(m_count + 1);
+    m_centerX[m_count] = sphere.Center.X;
+    m_centerY[m_count] = sphere.Center.Y;
+    m_centerZ[m_count] = sphere.Center.Z;
+    m_radius[m_count] = sphere.Radius;
+
+    return m_count++;
+}
+
+/**
+ * @brief Tests every sphere of the batch, returning an array holding a non zero value for each sphere that lies
+ * completely outside the frustum. The array stays valid until the batch is changed.
+ */
+const uint8_t *FrustumCullBatchClass::Cull(const FrustumClass &frustum)
+{
+    if (m_count == 0) {
+        return m_culled;
+    }
+
+    // Pad the last batch with spheres that are never looked at.
+    int padded = (m_count + CULL_BATCH_WIDTH - 1) & ~(CULL_BATCH_WIDTH - 1);
+
+    for (int i = m_count; i < padded; ++i) {
+        m_centerX[i] = 0.0f;
+        m_centerY[i] = 0.0f;
+        m_centerZ[i] = 0.0f;
+        m_radius[i] = 0.0f;
+    }
+
+#if defined FRUSTUMCULL_SSE
+    __m128 normal_x[FRUSTUM_PLANE_COUNT];
+    __m128 normal_y[FRUSTUM_PLANE_COUNT];
+    __m128 normal_z[FRUSTUM_PLANE_COUNT];
+    __m128 distance[FRUSTUM_PLANE_COUNT];
+
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        normal_x[p] = _mm_set1_ps(frustum.m_planes[p].N.X);
+        normal_y[p] = _mm_set1_ps(frustum.m_planes[p].N.Y);
+        normal_z[p] = _mm_set1_ps(frustum.m_planes[p].N.Z);
+        distance[p] = _mm_set1_ps(frustum.m_planes[p].D);
+    }
+
+    for (int i = 0; i < padded; i += CULL_BATCH_WIDTH) {
+        __m128 x = _mm_loadu_ps(&m_centerX[i]);
+        __m128 y = _mm_loadu_ps(&m_centerY[i]);
+        __m128 z = _mm_loadu_ps(&m_centerZ[i]);
+        __m128 r = _mm_loadu_ps(&m_radius[i]);
+        __m128 outside = _mm_setzero_ps();
+
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, normal_x[p]), _mm_mul_ps(y, normal_y[p])),
+                _mm_mul_ps(z, normal_z[p]));
+            outside = _mm_or_ps(outside, _mm_cmpgt_ps(_mm_sub_ps(dot, distance[p]), r));
+        }
+
+        int mask = _mm_movemask_ps(outside);
+        m_culled[i] = mask & 1;
+        m_culled[i + 1] = (mask >> 1) & 1;
+        m_culled[i + 2] = (mask >> 2) & 1;
+        m_culled[i + 3] = (mask >> 3) & 1;
+    }
+#elif defined FRUSTUMCULL_NEON
+    for (int i = 0; i < padded; i += CULL_BATCH_WIDTH) {
+        float32x4_t x = vld1q_f32(&m_centerX[i]);
+        float32x4_t y = vld1q_f32(&m_centerY[i]);
+        float32x4_t z = vld1q_f32(&m_centerZ[i]);
+        float32x4_t r = vld1q_f32(&m_radius[i]);
+        uint32x4_t outside = vdupq_n_u32(0);
+
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            const PlaneClass &plane = frustum.m_planes[p];
+            // Separate multiplies and adds rather than fused ones so the results round like the scalar test.
+            float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_n_f32(x, plane.N.X), vmulq_n_f32(y, plane.N.Y)),
+                vmulq_n_f32(z, plane.N.Z));
+            outside = vorrq_u32(outside, vcgtq_f32(vsubq_f32(dot, vdupq_n_f32(plane.D)), r));
+        }
+
+        uint32_t lanes[CULL_BATCH_WIDTH];
+        vst1q_u32(lanes, outside);
+        m_culled[i] = lanes[0] != 0;
+        m_culled[i + 1] = lanes[1] != 0;
+        m_culled[i + 2] = lanes[2] != 0;
+        m_culled[i + 3] = lanes[3] != 0;
+    }
+#else
+    for (int i = 0; i < padded; ++i) {
+        bool outside = false;
+
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            const PlaneClass &plane = frustum.m_planes[p];
+            float dot = m_centerX[i] * plane.N.X + m_centerY[i] * plane.N.Y + m_centerZ[i] * plane.N.Z - plane.D;
+            outside |= dot > m_radius[i];
+        }
+
+        m_culled[i] = outside;
+    }
+#endif
+
+    return m_culled;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Culls batches of bounding spheres against a view frustum several at a time.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#pragma once
+
+#include "always.h"
+
+class FrustumClass;
+class SphereClass;
+
+// CameraClass::Cull_Sphere tests one sphere against the frustum planes at a time, reading each sphere from wherever its
+// render object happens to live. Here the spheres of a whole scene are gathered into flat arrays first and tested four
+// at a time with SSE or NEON where available. A sphere is culled exactly when CollisionMath::Overlap_Test on the frustum
+// would report it outside, as the arithmetic is the same per plane and only the order of the planes differs.
+class FrustumCullBatchClass
+{
+public:
+    FrustumCullBatchClass();
+    ~FrustumCullBatchClass();
+
+    void Reset() { m_count = 0; }
+    int Add_Sphere(const SphereClass &sphere);
+    const uint8_t *Cull(const FrustumClass &frustum);
+    int Get_Count() const { return m_count; }
+    void Free();
+
+private:
+    void Reserve(int count);
+
+    float *m_centerX;
+    float *m_centerY;
+    float *m_centerZ;
+    float *m_radius;
+    uint8_t *m_culled;
+    int m_count;
+    int m_capacity;
+};
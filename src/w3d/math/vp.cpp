@@ -13,6 +13,7 @@
  *            LICENSE
  */
 #include "vp.h"
+#include "cpudetect.h"
 #include "gamemath.h"
 #include "matrix3d.h"
 #include "matrix4.h"
@@ -22,33 +23,923 @@
 #include <algorithm>
 #include <cstring>
 
+#if (defined PROCESSOR_X86 || defined PROCESSOR_X86_64) && !defined __WATCOMC__
+#include <immintrin.h>
+#define VP_X86
+#if defined __GNUC__ || defined __clang__
+#define VP_TARGET_SSE2 __attribute__((target("sse2")))
+#define VP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define VP_TARGET_SSE2
+#define VP_TARGET_AVX2
+#endif
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define VP_NEON
+#endif
+
 using std::memcpy;
 using std::memset;
 
-void VectorProcessorClass::Prefetch(void *address)
+namespace
+{
+// Routines with a wide version, the others are already bound by memory or, like Power, have no exact vector form.
+struct VectorKernelsStruct
 {
-    // Nothing in checked binaries, if found fill it in
+    void (*transform)(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count);
+    void (*transform_no_w)(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count);
+    void (*transform_4)(Vector4 *dst, const Vector3 *src, const Matrix4 &mtx, int count);
+    void (*copy_indexed)(uint32_t *dst, const uint32_t *src, const unsigned *index, int count);
+    void (*clamp)(float *dst, const float *src, float min, float max, int count);
+    void (*normalize)(Vector3 *dst, int count);
+    void (*min_max)(const Vector3 *src, Vector3 &min, Vector3 &max, int count);
+    void (*mul_add)(float *dest, float multiplier, float add, int count);
+    void (*dot_product)(float *dst, const Vector3 &a, const Vector3 *b, int count);
+    void (*clamp_min)(float *dst, const float *src, float min, int count);
+};
+
+void Transform_Scalar(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    while (count--) {
+        dst[count] = mtx * src[count];
+    }
 }
 
-void VectorProcessorClass::TransformNoW(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+void Transform_No_W_Scalar(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
 {
     for (int i = 0; i < count; i++) {
         dst[i] = mtx.Rotate_Vector(src[i]);
     }
 }
 
-void VectorProcessorClass::Transform(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+void Transform_4_Scalar(Vector4 *dst, const Vector3 *src, const Matrix4 &mtx, int count)
 {
     while (count--) {
         dst[count] = mtx * src[count];
     }
 }
 
-void VectorProcessorClass::Transform(Vector4 *dst, const Vector3 *src, const Matrix4 &mtx, int count)
+void Copy_Indexed_Scalar(uint32_t *dst, const uint32_t *src, const unsigned *index, int count)
 {
-    while (count--) {
-        dst[count] = mtx * src[count];
+    for (int i = 0; i < count; i++) {
+        dst[i] = src[index[i]];
+    }
+}
+
+void Clamp_Scalar(float *dst, const float *src, float min, float max, int count)
+{
+    for (int i = 0; i < count; i++) {
+        dst[i] = std::clamp(src[i], min, max);
+    }
+}
+
+void Normalize_Scalar(Vector3 *dst, int count)
+{
+    for (int i = 0; i < count; i++) {
+        dst[i].Normalize();
+    }
+}
+
+void Min_Max_Scalar(const Vector3 *src, Vector3 &min, Vector3 &max, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        min.Update_Min(src[i]);
+        max.Update_Max(src[i]);
+    }
+}
+
+void Mul_Add_Scalar(float *dest, float multiplier, float add, int count)
+{
+    for (int i = 0; i < count; i++) {
+        dest[i] = (dest[i] * multiplier) + add;
+    }
+}
+
+void Dot_Product_Scalar(float *dst, const Vector3 &a, const Vector3 *b, int count)
+{
+    for (int i = 0; i < count; i++) {
+        dst[i] = a * b[i];
+    }
+}
+
+void Clamp_Min_Scalar(float *dst, const float *src, float min, int count)
+{
+    for (int i = 0; i < count; i++) {
+        dst[i] = GameMath::Max(src[i], min);
+    }
+}
+
+const VectorKernelsStruct s_scalarKernels = {
+    Transform_Scalar,
+    Transform_No_W_Scalar,
+    Transform_4_Scalar,
+    Copy_Indexed_Scalar,
+    Clamp_Scalar,
+    Normalize_Scalar,
+    Min_Max_Scalar,
+    Mul_Add_Scalar,
+    Dot_Product_Scalar,
+    Clamp_Min_Scalar,
+};
+
+// The wide kernels below do the same multiplies and adds in the same order as the scalar ones and never fuse them, so
+// each lane rounds exactly like the scalar code. The last few elements that don't fill a register go to the scalar
+// kernels.
+
+#ifdef VP_X86
+// Turns four packed Vector3 into one register per component and back.
+VP_TARGET_SSE2 inline void Load_Vector3_SSE2(const Vector3 *src, __m128 &x, __m128 &y, __m128 &z)
+{
+    const float *p = &src->X;
+    __m128 a = _mm_loadu_ps(p); // x0 y0 z0 x1
+    __m128 b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+    __m128 c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(
+        _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(
+        _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+VP_TARGET_SSE2 inline void Store_Vector3_SSE2(Vector3 *dst, __m128 x, __m128 y, __m128 z)
+{
+    float *p = &dst->X;
+    _mm_storeu_ps(p,
+        _mm_shuffle_ps(
+            _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 4,
+        _mm_shuffle_ps(
+            _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(p + 8,
+        _mm_shuffle_ps(
+            _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+VP_TARGET_SSE2 void Transform_SSE2(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    __m128 m[3][4];
+
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            m[row][col] = _mm_set1_ps(mtx[row][col]);
+        }
+    }
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        Load_Vector3_SSE2(&src[i], x, y, z);
+        __m128 out[3];
+
+        for (int row = 0; row < 3; ++row) {
+            out[row] = _mm_add_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[row][0], x), _mm_mul_ps(m[row][1], y)), _mm_mul_ps(m[row][2], z)),
+                m[row][3]);
+        }
+
+        Store_Vector3_SSE2(&dst[i], out[0], out[1], out[2]);
+    }
+
+    Transform_Scalar(&dst[i], &src[i], mtx, count - i);
+}
+
+VP_TARGET_SSE2 void Transform_No_W_SSE2(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    __m128 m[3][3];
+
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            m[row][col] = _mm_set1_ps(mtx[row][col]);
+        }
+    }
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        Load_Vector3_SSE2(&src[i], x, y, z);
+        __m128 out[3];
+
+        for (int row = 0; row < 3; ++row) {
+            out[row] =
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[row][0], x), _mm_mul_ps(m[row][1], y)), _mm_mul_ps(m[row][2], z));
+        }
+
+        Store_Vector3_SSE2(&dst[i], out[0], out[1], out[2]);
+    }
+
+    Transform_No_W_Scalar(&dst[i], &src[i], mtx, count - i);
+}
+
+VP_TARGET_SSE2 void Transform_4_SSE2(Vector4 *dst, const Vector3 *src, const Matrix4 &mtx, int count)
+{
+    __m128 m[4][4];
+
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            m[row][col] = _mm_set1_ps(mtx[row][col]);
+        }
+    }
+
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        Load_Vector3_SSE2(&src[i], x, y, z);
+        __m128 out[4];
+
+        for (int row = 0; row < 4; ++row) {
+            out[row] = _mm_add_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[row][0], x), _mm_mul_ps(m[row][1], y)), _mm_mul_ps(m[row][2], z)),
+                m[row][3]);
+        }
+
+        _MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+        float *p = &dst[i].X;
+        _mm_storeu_ps(p, out[0]);
+        _mm_storeu_ps(p + 4, out[1]);
+        _mm_storeu_ps(p + 8, out[2]);
+        _mm_storeu_ps(p + 12, out[3]);
+    }
+
+    Transform_4_Scalar(&dst[i], &src[i], mtx, count - i);
+}
+
+VP_TARGET_SSE2 void Clamp_SSE2(float *dst, const float *src, float min, float max, int count)
+{
+    __m128 lo = _mm_set1_ps(min);
+    __m128 hi = _mm_set1_ps(max);
+    int i = 0;
+
+    // std::clamp picks min when src < min, else max when max < src, else src.
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(&dst[i], _mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(&src[i]))));
+    }
+
+    Clamp_Scalar(&dst[i], &src[i], min, max, count - i);
+}
+
+VP_TARGET_SSE2 void Normalize_SSE2(Vector3 *dst, int count)
+{
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        Load_Vector3_SSE2(&dst[i], x, y, z);
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        __m128 oolen = _mm_div_ps(one, _mm_sqrt_ps(len2));
+        __m128 keep = _mm_cmpeq_ps(len2, zero);
+        x = _mm_or_ps(_mm_and_ps(keep, x), _mm_andnot_ps(keep, _mm_mul_ps(x, oolen)));
+        y = _mm_or_ps(_mm_and_ps(keep, y), _mm_andnot_ps(keep, _mm_mul_ps(y, oolen)));
+        z = _mm_or_ps(_mm_and_ps(keep, z), _mm_andnot_ps(keep, _mm_mul_ps(z, oolen)));
+        Store_Vector3_SSE2(&dst[i], x, y, z);
+    }
+
+    Normalize_Scalar(&dst[i], count - i);
+}
+
+VP_TARGET_SSE2 void Min_Max_SSE2(const Vector3 *src, Vector3 &min, Vector3 &max, int count)
+{
+    __m128 min_x = _mm_set1_ps(min.X);
+    __m128 min_y = _mm_set1_ps(min.Y);
+    __m128 min_z = _mm_set1_ps(min.Z);
+    __m128 max_x = _mm_set1_ps(max.X);
+    __m128 max_y = _mm_set1_ps(max.Y);
+    __m128 max_z = _mm_set1_ps(max.Z);
+    int i = 0;
+
+    // Putting the new value first makes ties and NaNs keep the current one just like Update_Min and Update_Max.
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        Load_Vector3_SSE2(&src[i], x, y, z);
+        min_x = _mm_min_ps(x, min_x);
+        min_y = _mm_min_ps(y, min_y);
+        min_z = _mm_min_ps(z, min_z);
+        max_x = _mm_max_ps(x, max_x);
+        max_y = _mm_max_ps(y, max_y);
+        max_z = _mm_max_ps(z, max_z);
+    }
+
+    Vector3 lanes_min[4];
+    Vector3 lanes_max[4];
+    Store_Vector3_SSE2(lanes_min, min_x, min_y, min_z);
+    Store_Vector3_SSE2(lanes_max, max_x, max_y, max_z);
+    Min_Max_Scalar(lanes_min, min, max, 4);
+    Min_Max_Scalar(lanes_max, min, max, 4);
+    Min_Max_Scalar(&src[i], min, max, count - i);
+}
+
+VP_TARGET_SSE2 void Mul_Add_SSE2(float *dest, float multiplier, float add, int count)
+{
+    __m128 mul = _mm_set1_ps(multiplier);
+    __m128 offset = _mm_set1_ps(add);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(&dest[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&dest[i]), mul), offset));
+    }
+
+    Mul_Add_Scalar(&dest[i], multiplier, add, count - i);
+}
+
+VP_TARGET_SSE2 void Dot_Product_SSE2(float *dst, const Vector3 &a, const Vector3 *b, int count)
+{
+    __m128 a_x = _mm_set1_ps(a.X);
+    __m128 a_y = _mm_set1_ps(a.Y);
+    __m128 a_z = _mm_set1_ps(a.Z);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        Load_Vector3_SSE2(&b[i], x, y, z);
+        _mm_storeu_ps(&dst[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(a_x, x), _mm_mul_ps(a_y, y)), _mm_mul_ps(a_z, z)));
+    }
+
+    Dot_Product_Scalar(&dst[i], a, &b[i], count - i);
+}
+
+VP_TARGET_SSE2 void Clamp_Min_SSE2(float *dst, const float *src, float min, int count)
+{
+    __m128 lo = _mm_set1_ps(min);
+    int i = 0;
+
+    // Like fmaxf a NaN source gives the minimum.
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(&dst[i], _mm_max_ps(_mm_loadu_ps(&src[i]), lo));
+    }
+
+    Clamp_Min_Scalar(&dst[i], &src[i], min, count - i);
+}
+
+const VectorKernelsStruct s_sse2Kernels = {
+    Transform_SSE2,
+    Transform_No_W_SSE2,
+    Transform_4_SSE2,
+    Copy_Indexed_Scalar,
+    Clamp_SSE2,
+    Normalize_SSE2,
+    Min_Max_SSE2,
+    Mul_Add_SSE2,
+    Dot_Product_SSE2,
+    Clamp_Min_SSE2,
+};
+
+// The AVX shuffles work within each 128 bit half, so eight Vector3 are split into two groups of four that go through
+// the same shuffles as the SSE2 version side by side.
+VP_TARGET_AVX2 inline __m256 Load_Halves_AVX2(const float *low, const float *high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+VP_TARGET_AVX2 inline void Store_Halves_AVX2(float *low, float *high, __m256 value)
+{
+    _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+    _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+}
+
+VP_TARGET_AVX2 inline void Load_Vector3_AVX2(const Vector3 *src, __m256 &x, __m256 &y, __m256 &z)
+{
+    const float *p = &src->X;
+    __m256 a = Load_Halves_AVX2(p, p + 12);
+    __m256 b = Load_Halves_AVX2(p + 4, p + 16);
+    __m256 c = Load_Halves_AVX2(p + 8, p + 20);
+    x = _mm256_shuffle_ps(a, _mm256_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)),
+        _mm256_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)),
+        _mm256_shuffle_ps(c, c, _MM_SHUFFLE(0, 3, 0, 0)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+VP_TARGET_AVX2 inline void Store_Vector3_AVX2(Vector3 *dst, __m256 x, __m256 y, __m256 z)
+{
+    float *p = &dst->X;
+    Store_Halves_AVX2(p,
+        p + 12,
+        _mm256_shuffle_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+            _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+            _MM_SHUFFLE(2, 0, 2, 0)));
+    Store_Halves_AVX2(p + 4,
+        p + 16,
+        _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+            _MM_SHUFFLE(2, 0, 2, 0)));
+    Store_Halves_AVX2(p + 8,
+        p + 20,
+        _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+            _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+            _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+VP_TARGET_AVX2 void Transform_AVX2(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    __m256 m[3][4];
+
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            m[row][col] = _mm256_set1_ps(mtx[row][col]);
+        }
+    }
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        Load_Vector3_AVX2(&src[i], x, y, z);
+        __m256 out[3];
+
+        for (int row = 0; row < 3; ++row) {
+            out[row] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[row][0], x), _mm256_mul_ps(m[row][1], y)),
+                                         _mm256_mul_ps(m[row][2], z)),
+                m[row][3]);
+        }
+
+        Store_Vector3_AVX2(&dst[i], out[0], out[1], out[2]);
+    }
+
+    Transform_SSE2(&dst[i], &src[i], mtx, count - i);
+}
+
+VP_TARGET_AVX2 void Transform_No_W_AVX2(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    __m256 m[3][3];
+
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            m[row][col] = _mm256_set1_ps(mtx[row][col]);
+        }
+    }
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        Load_Vector3_AVX2(&src[i], x, y, z);
+        __m256 out[3];
+
+        for (int row = 0; row < 3; ++row) {
+            out[row] = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(m[row][0], x), _mm256_mul_ps(m[row][1], y)), _mm256_mul_ps(m[row][2], z));
+        }
+
+        Store_Vector3_AVX2(&dst[i], out[0], out[1], out[2]);
+    }
+
+    Transform_No_W_SSE2(&dst[i], &src[i], mtx, count - i);
+}
+
+VP_TARGET_AVX2 void Transform_4_AVX2(Vector4 *dst, const Vector3 *src, const Matrix4 &mtx, int count)
+{
+    __m256 m[4][4];
+
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            m[row][col] = _mm256_set1_ps(mtx[row][col]);
+        }
+    }
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        Load_Vector3_AVX2(&src[i], x, y, z);
+        __m256 out[4];
+
+        for (int row = 0; row < 4; ++row) {
+            out[row] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[row][0], x), _mm256_mul_ps(m[row][1], y)),
+                                         _mm256_mul_ps(m[row][2], z)),
+                m[row][3]);
+        }
+
+        // Transpose within each half, the low halves then hold vectors 0 to 3 and the high halves vectors 4 to 7.
+        __m256 xy_low = _mm256_unpacklo_ps(out[0], out[1]);
+        __m256 zw_low = _mm256_unpacklo_ps(out[2], out[3]);
+        __m256 xy_high = _mm256_unpackhi_ps(out[0], out[1]);
+        __m256 zw_high = _mm256_unpackhi_ps(out[2], out[3]);
+        __m256 v0 = _mm256_shuffle_ps(xy_low, zw_low, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 v1 = _mm256_shuffle_ps(xy_low, zw_low, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 v2 = _mm256_shuffle_ps(xy_high, zw_high, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 v3 = _mm256_shuffle_ps(xy_high, zw_high, _MM_SHUFFLE(3, 2, 3, 2));
+        float *p = &dst[i].X;
+        _mm256_storeu_ps(p, _mm256_permute2f128_ps(v0, v1, 0x20));
+        _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(v2, v3, 0x20));
+        _mm256_storeu_ps(p + 16, _mm256_permute2f128_ps(v0, v1, 0x31));
+        _mm256_storeu_ps(p + 24, _mm256_permute2f128_ps(v2, v3, 0x31));
+    }
+
+    Transform_4_SSE2(&dst[i], &src[i], mtx, count - i);
+}
+
+VP_TARGET_AVX2 void Copy_Indexed_AVX2(uint32_t *dst, const uint32_t *src, const unsigned *index, int count)
+{
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&index[i]));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(&dst[i]), _mm256_i32gather_epi32(reinterpret_cast<const int *>(src), idx, 4));
+    }
+
+    Copy_Indexed_Scalar(&dst[i], src, &index[i], count - i);
+}
+
+VP_TARGET_AVX2 void Clamp_AVX2(float *dst, const float *src, float min, float max, int count)
+{
+    __m256 lo = _mm256_set1_ps(min);
+    __m256 hi = _mm256_set1_ps(max);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(&dst[i], _mm256_min_ps(hi, _mm256_max_ps(lo, _mm256_loadu_ps(&src[i]))));
+    }
+
+    Clamp_SSE2(&dst[i], &src[i], min, max, count - i);
+}
+
+VP_TARGET_AVX2 void Normalize_AVX2(Vector3 *dst, int count)
+{
+    __m256 zero = _mm256_setzero_ps();
+    __m256 one = _mm256_set1_ps(1.0f);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        Load_Vector3_AVX2(&dst[i], x, y, z);
+        __m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+        __m256 oolen = _mm256_div_ps(one, _mm256_sqrt_ps(len2));
+        __m256 scale = _mm256_cmp_ps(len2, zero, _CMP_NEQ_UQ);
+        x = _mm256_blendv_ps(x, _mm256_mul_ps(x, oolen), scale);
+        y = _mm256_blendv_ps(y, _mm256_mul_ps(y, oolen), scale);
+        z = _mm256_blendv_ps(z, _mm256_mul_ps(z, oolen), scale);
+        Store_Vector3_AVX2(&dst[i], x, y, z);
+    }
+
+    Normalize_SSE2(&dst[i], count - i);
+}
+
+VP_TARGET_AVX2 void Min_Max_AVX2(const Vector3 *src, Vector3 &min, Vector3 &max, int count)
+{
+    __m256 min_x = _mm256_set1_ps(min.X);
+    __m256 min_y = _mm256_set1_ps(min.Y);
+    __m256 min_z = _mm256_set1_ps(min.Z);
+    __m256 max_x = _mm256_set1_ps(max.X);
+    __m256 max_y = _mm256_set1_ps(max.Y);
+    __m256 max_z = _mm256_set1_ps(max.Z);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        Load_Vector3_AVX2(&src[i], x, y, z);
+        min_x = _mm256_min_ps(x, min_x);
+        min_y = _mm256_min_ps(y, min_y);
+        min_z = _mm256_min_ps(z, min_z);
+        max_x = _mm256_max_ps(x, max_x);
+        max_y = _mm256_max_ps(y, max_y);
+        max_z = _mm256_max_ps(z, max_z);
+    }
+
+    Vector3 lanes_min[8];
+    Vector3 lanes_max[8];
+    Store_Vector3_AVX2(lanes_min, min_x, min_y, min_z);
+    Store_Vector3_AVX2(lanes_max, max_x, max_y, max_z);
+    Min_Max_Scalar(lanes_min, min, max, 8);
+    Min_Max_Scalar(lanes_max, min, max, 8);
+    Min_Max_SSE2(&src[i], min, max, count - i);
+}
+
+VP_TARGET_AVX2 void Mul_Add_AVX2(float *dest, float multiplier, float add, int count)
+{
+    __m256 mul = _mm256_set1_ps(multiplier);
+    __m256 offset = _mm256_set1_ps(add);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(&dest[i], _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&dest[i]), mul), offset));
+    }
+
+    Mul_Add_SSE2(&dest[i], multiplier, add, count - i);
+}
+
+VP_TARGET_AVX2 void Dot_Product_AVX2(float *dst, const Vector3 &a, const Vector3 *b, int count)
+{
+    __m256 a_x = _mm256_set1_ps(a.X);
+    __m256 a_y = _mm256_set1_ps(a.Y);
+    __m256 a_z = _mm256_set1_ps(a.Z);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        Load_Vector3_AVX2(&b[i], x, y, z);
+        _mm256_storeu_ps(
+            &dst[i], _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a_x, x), _mm256_mul_ps(a_y, y)), _mm256_mul_ps(a_z, z)));
+    }
+
+    Dot_Product_SSE2(&dst[i], a, &b[i], count - i);
+}
+
+VP_TARGET_AVX2 void Clamp_Min_AVX2(float *dst, const float *src, float min, int count)
+{
+    __m256 lo = _mm256_set1_ps(min);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(&dst[i], _mm256_max_ps(_mm256_loadu_ps(&src[i]), lo));
+    }
+
+    Clamp_Min_SSE2(&dst[i], &src[i], min, count - i);
+}
+
+const VectorKernelsStruct s_avx2Kernels = {
+    Transform_AVX2,
+    Transform_No_W_AVX2,
+    Transform_4_AVX2,
+    Copy_Indexed_AVX2,
+    Clamp_AVX2,
+    Normalize_AVX2,
+    Min_Max_AVX2,
+    Mul_Add_AVX2,
+    Dot_Product_AVX2,
+    Clamp_Min_AVX2,
+};
+#endif
+
+#ifdef VP_NEON
+// NEON loads and stores Vector3 and Vector4 arrays as separate components directly.
+void Transform_NEON(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t in = vld3q_f32(&src[i].X);
+        float32x4x3_t out;
+
+        for (int row = 0; row < 3; ++row) {
+            out.val[row] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(in.val[0], mtx[row][0]), vmulq_n_f32(in.val[1], mtx[row][1])),
+                                         vmulq_n_f32(in.val[2], mtx[row][2])),
+                vdupq_n_f32(mtx[row][3]));
+        }
+
+        vst3q_f32(&dst[i].X, out);
+    }
+
+    Transform_Scalar(&dst[i], &src[i], mtx, count - i);
+}
+
+void Transform_No_W_NEON(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t in = vld3q_f32(&src[i].X);
+        float32x4x3_t out;
+
+        for (int row = 0; row < 3; ++row) {
+            out.val[row] = vaddq_f32(vaddq_f32(vmulq_n_f32(in.val[0], mtx[row][0]), vmulq_n_f32(in.val[1], mtx[row][1])),
+                vmulq_n_f32(in.val[2], mtx[row][2]));
+        }
+
+        vst3q_f32(&dst[i].X, out);
+    }
+
+    Transform_No_W_Scalar(&dst[i], &src[i], mtx, count - i);
+}
+
+void Transform_4_NEON(Vector4 *dst, const Vector3 *src, const Matrix4 &mtx, int count)
+{
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t in = vld3q_f32(&src[i].X);
+        float32x4x4_t out;
+
+        for (int row = 0; row < 4; ++row) {
+            out.val[row] = vaddq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(in.val[0], mtx[row][0]), vmulq_n_f32(in.val[1], mtx[row][1])),
+                                         vmulq_n_f32(in.val[2], mtx[row][2])),
+                vdupq_n_f32(mtx[row][3]));
+        }
+
+        vst4q_f32(&dst[i].X, out);
+    }
+
+    Transform_4_Scalar(&dst[i], &src[i], mtx, count - i);
+}
+
+void Clamp_NEON(float *dst, const float *src, float min, float max, int count)
+{
+    float32x4_t lo = vdupq_n_f32(min);
+    float32x4_t hi = vdupq_n_f32(max);
+    int i = 0;
+
+    // Selects rather than vminq and vmaxq, those return NaN where std::clamp passes the source through.
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t value = vld1q_f32(&src[i]);
+        value = vbslq_f32(vcltq_f32(value, lo), lo, value);
+        vst1q_f32(&dst[i], vbslq_f32(vcltq_f32(hi, value), hi, value));
+    }
+
+    Clamp_Scalar(&dst[i], &src[i], min, max, count - i);
+}
+
+void Min_Max_NEON(const Vector3 *src, Vector3 &min, Vector3 &max, int count)
+{
+    float32x4x3_t lanes_min;
+    float32x4x3_t lanes_max;
+    lanes_min.val[0] = vdupq_n_f32(min.X);
+    lanes_min.val[1] = vdupq_n_f32(min.Y);
+    lanes_min.val[2] = vdupq_n_f32(min.Z);
+    lanes_max.val[0] = vdupq_n_f32(max.X);
+    lanes_max.val[1] = vdupq_n_f32(max.Y);
+    lanes_max.val[2] = vdupq_n_f32(max.Z);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t in = vld3q_f32(&src[i].X);
+
+        for (int c = 0; c < 3; ++c) {
+            lanes_min.val[c] = vbslq_f32(vcltq_f32(in.val[c], lanes_min.val[c]), in.val[c], lanes_min.val[c]);
+            lanes_max.val[c] = vbslq_f32(vcgtq_f32(in.val[c], lanes_max.val[c]), in.val[c], lanes_max.val[c]);
+        }
+    }
+
+    Vector3 found_min[4];
+    Vector3 found_max[4];
+    vst3q_f32(&found_min[0].X, lanes_min);
+    vst3q_f32(&found_max[0].X, lanes_max);
+    Min_Max_Scalar(found_min, min, max, 4);
+    Min_Max_Scalar(found_max, min, max, 4);
+    Min_Max_Scalar(&src[i], min, max, count - i);
+}
+
+void Mul_Add_NEON(float *dest, float multiplier, float add, int count)
+{
+    float32x4_t offset = vdupq_n_f32(add);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(&dest[i], vaddq_f32(vmulq_n_f32(vld1q_f32(&dest[i]), multiplier), offset));
+    }
+
+    Mul_Add_Scalar(&dest[i], multiplier, add, count - i);
+}
+
+void Dot_Product_NEON(float *dst, const Vector3 &a, const Vector3 *b, int count)
+{
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t in = vld3q_f32(&b[i].X);
+        vst1q_f32(&dst[i],
+            vaddq_f32(vaddq_f32(vmulq_n_f32(in.val[0], a.X), vmulq_n_f32(in.val[1], a.Y)), vmulq_n_f32(in.val[2], a.Z)));
     }
+
+    Dot_Product_Scalar(&dst[i], a, &b[i], count - i);
+}
+
+void Clamp_Min_NEON(float *dst, const float *src, float min, int count)
+{
+    float32x4_t lo = vdupq_n_f32(min);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t value = vld1q_f32(&src[i]);
+        vst1q_f32(&dst[i], vbslq_f32(vcgtq_f32(value, lo), value, lo));
+    }
+
+    Clamp_Min_Scalar(&dst[i], &src[i], min, count - i);
+}
+
+// Only AArch64 has vector divide and square root, 32 bit NEON would need estimates that don't match the scalar bits.
+#ifdef __aarch64__
+void Normalize_NEON(Vector3 *dst, int count)
+{
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t one = vdupq_n_f32(1.0f);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t v = vld3q_f32(&dst[i].X);
+        float32x4_t len2 =
+            vaddq_f32(vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1])), vmulq_f32(v.val[2], v.val[2]));
+        float32x4_t oolen = vdivq_f32(one, vsqrtq_f32(len2));
+        uint32x4_t keep = vceqq_f32(len2, zero);
+
+        for (int c = 0; c < 3; ++c) {
+            v.val[c] = vbslq_f32(keep, v.val[c], vmulq_f32(v.val[c], oolen));
+        }
+
+        vst3q_f32(&dst[i].X, v);
+    }
+
+    Normalize_Scalar(&dst[i], count - i);
+}
+#else
+#define Normalize_NEON Normalize_Scalar
+#endif
+
+const VectorKernelsStruct s_neonKernels = {
+    Transform_NEON,
+    Transform_No_W_NEON,
+    Transform_4_NEON,
+    Copy_Indexed_Scalar,
+    Clamp_NEON,
+    Normalize_NEON,
+    Min_Max_NEON,
+    Mul_Add_NEON,
+    Dot_Product_NEON,
+    Clamp_Min_NEON,
+};
+#endif
+
+VectorProcessorClass::InstructionSetType s_instructionSet = VectorProcessorClass::INSTRUCTIONS_COUNT;
+const VectorKernelsStruct *s_kernels = nullptr;
+
+const VectorKernelsStruct *Get_Kernels(VectorProcessorClass::InstructionSetType type)
+{
+    switch (type) {
+        case VectorProcessorClass::INSTRUCTIONS_SCALAR:
+            return &s_scalarKernels;
+#ifdef VP_X86
+        case VectorProcessorClass::INSTRUCTIONS_SSE2:
+            return CPUDetectClass::Has_SSE2_Instruction_Set() ? &s_sse2Kernels : nullptr;
+        case VectorProcessorClass::INSTRUCTIONS_AVX2:
+            return CPUDetectClass::Has_SSE2_Instruction_Set() && CPUDetectClass::Has_AVX2_Instruction_Set() ?
+                &s_avx2Kernels :
+                nullptr;
+#endif
+#ifdef VP_NEON
+        case VectorProcessorClass::INSTRUCTIONS_NEON:
+            return &s_neonKernels;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+// Kernels are picked on first use rather than during static init so the processor features are known by then.
+const VectorKernelsStruct &Kernels()
+{
+    if (s_kernels == nullptr) {
+        for (int type = VectorProcessorClass::INSTRUCTIONS_COUNT - 1; type >= 0; --type) {
+            if (VectorProcessorClass::Set_Instruction_Set(VectorProcessorClass::InstructionSetType(type))) {
+                break;
+            }
+        }
+    }
+
+    return *s_kernels;
+}
+} // namespace
+
+bool VectorProcessorClass::Is_Instruction_Set_Supported(InstructionSetType type)
+{
+    return Get_Kernels(type) != nullptr;
+}
+
+bool VectorProcessorClass::Set_Instruction_Set(InstructionSetType type)
+{
+    const VectorKernelsStruct *kernels = Get_Kernels(type);
+
+    if (kernels == nullptr) {
+        return false;
+    }
+
+    s_kernels = kernels;
+    s_instructionSet = type;
+    return true;
+}
+
+VectorProcessorClass::InstructionSetType VectorProcessorClass::Get_Instruction_Set()
+{
+    Kernels();
+    return s_instructionSet;
+}
+
+void VectorProcessorClass::Prefetch(void *address)
+{
+#ifdef VP_X86
+    _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#elif defined __GNUC__ || defined __clang__
+    __builtin_prefetch(address);
+#endif
+}
+
+void VectorProcessorClass::TransformNoW(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    Kernels().transform_no_w(dst, src, mtx, count);
+}
+
+void VectorProcessorClass::Transform(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count)
+{
+    Kernels().transform(dst, src, mtx, count);
+}
+
+void VectorProcessorClass::Transform(Vector4 *dst, const Vector3 *src, const Matrix4 &mtx, int count)
+{
+    Kernels().transform_4(dst, src, mtx, count);
 }
 
 void VectorProcessorClass::Copy(Vector2 *dst, const Vector2 *src, int count)
@@ -111,9 +1002,7 @@ void VectorProcessorClass::Copy(Vector4 *dst, const Vector3 &src, const float *s
 
 void VectorProcessorClass::CopyIndexed(unsigned *dst, const unsigned *src, const unsigned *index, int count)
 {
-    for (int i = 0; i < count; i++) {
-        dst[i] = src[index[i]];
-    }
+    Kernels().copy_indexed(reinterpret_cast<uint32_t *>(dst), reinterpret_cast<const uint32_t *>(src), index, count);
 }
 
 // i think this is right
@@ -149,18 +1038,13 @@ void VectorProcessorClass::CopyIndexed(unsigned char *dst, unsigned char *src, c
 
 void VectorProcessorClass::CopyIndexed(float *dst, float *src, const unsigned *index, int count)
 {
-    for (int i = 0; i < count; i++) {
-        dst[i] = src[index[i]];
-    }
+    Kernels().copy_indexed(reinterpret_cast<uint32_t *>(dst), reinterpret_cast<const uint32_t *>(src), index, count);
 }
 
 void VectorProcessorClass::Clamp(Vector4 *dst, const Vector4 *src, float min, float max, int count)
 {
-    for (int i = 0; i < count; i++) {
-        dst[i].X = std::clamp(src[i].X, min, max);
-        dst[i].Y = std::clamp(src[i].Y, min, max);
-        dst[i].Z = std::clamp(src[i].Z, min, max);
-        dst[i].W = std::clamp(src[i].W, min, max);
+    if (count > 0) {
+        Kernels().clamp(&dst->X, &src->X, min, max, 4 * count);
     }
 }
 
@@ -173,9 +1057,7 @@ void VectorProcessorClass::Clear(Vector3 *dst, int count)
 
 void VectorProcessorClass::Normalize(Vector3 *dst, int count)
 {
-    for (int i = 0; i < count; i++) {
-        dst[i].Normalize();
-    }
+    Kernels().normalize(dst, count);
 }
 
 // This has a bugfix where it always set minf value only dunno what consequences fixing this could cause
@@ -184,33 +1066,23 @@ void VectorProcessorClass::MinMax(Vector3 *src, Vector3 &min, Vector3 &max, int
     if (count > 0) {
         min = src[0];
         max = src[0];
-
-        for (int i = 1; i < count; ++i) {
-            min.Update_Min(src[i]);
-            max.Update_Max(src[i]);
-        }
+        Kernels().min_max(&src[1], min, max, count - 1);
     }
 }
 
 void VectorProcessorClass::MulAdd(float *dest, float multiplier, float add, int count)
 {
-    for (int i = 0; i < count; i++) {
-        dest[i] = (dest[i] * multiplier) + add;
-    }
+    Kernels().mul_add(dest, multiplier, add, count);
 }
 
 void VectorProcessorClass::DotProduct(float *dst, const Vector3 &a, const Vector3 *b, int count)
 {
-    for (int i = 0; i < count; i++) {
-        dst[i] = a * b[i];
-    }
+    Kernels().dot_product(dst, a, b, count);
 }
 
 void VectorProcessorClass::ClampMin(float *dst, float *src, float min, int count)
 {
-    for (int i = 0; i < count; i++) {
-        dst[i] = GameMath::Max(src[i], min);
-    }
+    Kernels().clamp_min(dst, src, min, count);
 }
 
 void VectorProcessorClass::Power(float *dst, float *src, float pow, int count)
@@ -22,9 +22,24 @@ class Vector4;
 class Matrix3D;
 class Matrix4;
 
+// The routines pick kernels for the best instruction set the processor has on first use. Every kernel gives the same
+// bits as the scalar loop it replaces, the instruction set can be forced to compare or time them.
 class VectorProcessorClass
 {
 public:
+    enum InstructionSetType
+    {
+        INSTRUCTIONS_SCALAR,
+        INSTRUCTIONS_SSE2,
+        INSTRUCTIONS_AVX2,
+        INSTRUCTIONS_NEON,
+        INSTRUCTIONS_COUNT,
+    };
+
+    static bool Is_Instruction_Set_Supported(InstructionSetType type);
+    static bool Set_Instruction_Set(InstructionSetType type);
+    static InstructionSetType Get_Instruction_Set();
+
     static void Prefetch(void *address);
     static void TransformNoW(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count);
     static void Transform(Vector3 *dst, const Vector3 *src, const Matrix3D &mtx, int count);
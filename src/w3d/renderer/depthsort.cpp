@@ -0,0 +1,165 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Stable radix sort on depth used to order translucent geometry.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include "depthsort.h"
+#include <cstring>
+
+enum
+{
+    RADIX_BITS = 8,
+    RADIX_SIZE = 1 << RADIX_BITS,
+    RADIX_PASSES = 32 / RADIX_BITS,
+    INSERTION_SORT_COUNT = 32, // Below this a plain insertion sort beats clearing the histograms.
+};
+
+DepthSortClass::DepthSortClass() : m_capacity(0)
+{
+    m_keys[0] = nullptr;
+    m_keys[1] = nullptr;
+    m_order[0] = nullptr;
+    m_order[1] = nullptr;
+}
+
+DepthSortClass::~DepthSortClass()
+{
+    Free();
+}
+
+void DepthSortClass::Free()
+{
+    for (int i = 0; i < 2; ++i) {
+        delete[] m_keys[i];
+        delete[] m_order[i];
+        m_keys[i] = nullptr;
+        m_order[i] = nullptr;
+    }
+
+    m_capacity = 0;
+}
+
+void DepthSortClass::Reserve(unsigned count)
+{
+    if (count <= m_capacity) {
+        return;
+    }
+
+    Free();
+
+    for (int i = 0; i < 2; ++i) {
+        m_keys[i] = new uint32_t[count];
+        m_order[i] = new uint32_t[count];
+    }
+
+    m_capacity = count;
+}
+
+/**
+ * @brief Gets the array the keys to sort are written to, any keys already in it are lost when it has to grow.
+ */
+uint32_t *DepthSortClass::Get_Key_Array(unsigned count)
+{
+    Reserve(count);
+    return m_keys[0];
+}
+
+/**
+ * @brief Sorts the first count keys of the key array, returning the indices of the keys in ascending order. Equal keys
+ * keep the order they were written in. The returned array stays valid until the next call.
+ */
+const uint32_t *DepthSortClass::Sort(unsigned count)
+{
+    Reserve(count);
+    uint32_t *keys = m_keys[0];
+    uint32_t *order = m_order[0];
+
+    if (count <= INSERTION_SORT_COUNT) {
+        for (unsigned i = 0; i < count; ++i) {
+            uint32_t key = keys[i];
+            unsigned j = i;
+
+            for (; j > 0 && keys[j - 1] > key; --j) {
+                keys[j] = keys[j - 1];
+                order[j] = order[j - 1];
+            }
+
+            keys[j] = key;
+            order[j] = i;
+        }
+
+        return order;
+    }
+
+    unsigned counts[RADIX_PASSES][RADIX_SIZE];
+    memset(counts, 0, sizeof(counts));
+
+    for (unsigned i = 0; i < count; ++i) {
+        uint32_t key = keys[i];
+        order[i] = i;
+
+        for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+            ++counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)];
+        }
+    }
+
+    uint32_t *other_keys = m_keys[1];
+    uint32_t *other_order = m_order[1];
+
+    for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+        unsigned *bucket = counts[pass];
+        int shift = pass * RADIX_BITS;
+
+        // Every key has the same digit here so the pass wouldn't move anything.
+        if (bucket[(keys[0] >> shift) & (RADIX_SIZE - 1)] == count) {
+            continue;
+        }
+
+        unsigned offset = 0;
+
+        for (int i = 0; i < RADIX_SIZE; ++i) {
+            unsigned size = bucket[i];
+            bucket[i] = offset;
+            offset += size;
+        }
+
+        for (unsigned i = 0; i < count; ++i) {
+            unsigned dest = bucket[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+            other_keys[dest] = keys[i];
+            other_order[dest] = order[i];
+        }
+
+        uint32_t *swap_keys = keys;
+        uint32_t *swap_order = order;
+        keys = other_keys;
+        order = other_order;
+        other_keys = swap_keys;
+        other_order = swap_order;
+    }
+
+    return order;
+}
+
+/**
+ * @brief Turns a depth into a key whose unsigned order matches the order of the floats, with both zeros equal.
+ */
+uint32_t DepthSortClass::Ascending_Key(float depth)
+{
+    if (depth == 0.0f) {
+        depth = 0.0f;
+    }
+
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+
+    return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+}
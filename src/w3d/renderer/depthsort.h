@@ -0,0 +1,43 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Stable radix sort on depth used to order translucent geometry.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#pragma once
+
+#include "always.h"
+
+// The sorting renderer used to keep its nodes ordered by walking the node list on every insert and sorted the triangles
+// of the overlapping pool with a comparison sort. Depths are turned into unsigned keys that compare the same way the
+// floats do, so a least significant digit radix sort over the keys orders a whole frame in a few linear passes while
+// keeping equal depths in the order they were added. Byte positions every key shares are skipped, which for the narrow
+// depth range of a single frame usually leaves only two or three passes.
+class DepthSortClass
+{
+public:
+    DepthSortClass();
+    ~DepthSortClass();
+
+    uint32_t *Get_Key_Array(unsigned count);
+    const uint32_t *Sort(unsigned count);
+    void Free();
+
+    static uint32_t Ascending_Key(float depth);
+    static uint32_t Descending_Key(float depth) { return ~Ascending_Key(depth); }
+
+private:
+    void Reserve(unsigned count);
+
+    uint32_t *m_keys[2];
+    uint32_t *m_order[2];
+    unsigned m_capacity;
+};
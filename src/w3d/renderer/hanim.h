@@ -18,6 +18,9 @@
 #include "always.h"
 #include "hash.h"
 #include "refcount.h"
+#ifndef GAME_DLL
+#include <atomic>
+#endif
 
 class Vector3;
 class Quaternion;
@@ -32,7 +35,14 @@ public:
         CLASSID_RAW = 0,
     };
 
-    HAnimClass() : m_embeddedSoundBoneIndex(-1) {}
+    HAnimClass() :
+        m_embeddedSoundBoneIndex(-1)
+#ifndef GAME_DLL
+        ,
+        m_serial(Next_Serial())
+#endif
+    {
+    }
     virtual ~HAnimClass(){};
     virtual const char *Get_Name() const = 0;
     virtual const char *Get_HName() const = 0;
@@ -58,6 +68,22 @@ public:
     virtual void Set_Embedded_Sound_Bone_Index(int index) { m_embeddedSoundBoneIndex = index; };
     virtual int Get_Embedded_Sound_Bone_Index() { return m_embeddedSoundBoneIndex; }
 
+#ifndef GAME_DLL
+    // Differs between animations that end up at the same address, so data cached for a freed one is never reused.
+    uint32_t Get_Serial() const { return m_serial; }
+#endif
+
 protected:
     int m_embeddedSoundBoneIndex;
+
+#ifndef GAME_DLL
+private:
+    static uint32_t Next_Serial()
+    {
+        static std::atomic<uint32_t> s_nextSerial(0);
+        return ++s_nextSerial;
+    }
+
+    uint32_t m_serial;
+#endif
 };
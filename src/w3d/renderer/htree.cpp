@@ -21,9 +21,438 @@
 #include <cstring>
 #include <strings.h>
 
+#if defined PROCESSOR_X86 || defined PROCESSOR_X86_64
+#include <xmmintrin.h>
+#define HTREE_SSE
+#elif defined __ARM_NEON
+#include <arm_neon.h>
+#define HTREE_NEON
+#endif
+
 using std::memcpy;
 using std::strcpy;
 
+enum
+{
+    POSE_BATCH_WIDTH = 4,
+};
+
+enum PoseVisibility
+{
+    POSE_HIDDEN,
+    POSE_VISIBLE,
+    POSE_VISIBILITY_UNCHANGED,
+};
+
+// The animated updates used to fetch a pivot's channels, build its rotation matrix and push it down the hierarchy one
+// pivot at a time. They now sample every channel of the animation into flat per component arrays first, turn all the
+// quaternions into matrices several at a time and only then walk the hierarchy. Sampling goes through the animation's
+// virtual interface and its channel caches while the other two steps touch nothing but this scratch storage and the
+// pivots of the tree being updated.
+class PoseBatchClass
+{
+public:
+    PoseBatchClass() : m_visibility(nullptr), m_hasRotation(nullptr), m_capacity(0)
+    {
+        memset(m_translation, 0, sizeof(m_translation));
+        memset(m_rotation, 0, sizeof(m_rotation));
+        memset(m_matrix, 0, sizeof(m_matrix));
+    }
+
+    ~PoseBatchClass() { Free(); }
+
+    void Reserve(int count);
+    void Free();
+
+    void Set_Translation(int index, float x, float y, float z)
+    {
+        m_translation[0][index] = x;
+        m_translation[1][index] = y;
+        m_translation[2][index] = z;
+    }
+
+    void Set_Rotation(int index, const Quaternion &q)
+    {
+        m_rotation[0][index] = q[0];
+        m_rotation[1][index] = q[1];
+        m_rotation[2][index] = q[2];
+        m_rotation[3][index] = q[3];
+        m_hasRotation[index] = true;
+    }
+
+    void Clear_Rotation(int index)
+    {
+        m_rotation[0][index] = 0.0f;
+        m_rotation[1][index] = 0.0f;
+        m_rotation[2][index] = 0.0f;
+        m_rotation[3][index] = 1.0f;
+        m_hasRotation[index] = false;
+    }
+
+    void Set_Visibility(int index, PoseVisibility visibility) { m_visibility[index] = visibility; }
+
+    void Build_Matrices(int count);
+    void Apply(PivotClass *pivots, int num_pivots, int num_anim_pivots) const;
+
+private:
+    float *m_translation[3];
+    float *m_rotation[4];
+    float *m_matrix[9];
+    uint8_t *m_visibility;
+    uint8_t *m_hasRotation;
+    int m_capacity;
+};
+
+static PoseBatchClass s_poseBatch;
+
+enum PoseSource
+{
+    POSE_SOURCE_ANIM,
+    POSE_SOURCE_RAW_ANIM,
+    POSE_SOURCE_BLEND,
+};
+
+// Everything a sampled pose depends on. Frames are compared bit for bit rather than quantized, so a cached pose is always
+// exactly the one sampling would have produced.
+struct PoseKeyStruct
+{
+    PoseKeyStruct() { memset(this, 0, sizeof(*this)); }
+
+    PoseKeyStruct(PoseSource pose_source,
+        int num_sampled,
+        const HAnimClass *motion0,
+        float frame0,
+        const HAnimClass *motion1 = nullptr,
+        float frame1 = 0.0f,
+        float blend = 0.0f,
+        float scale_factor = 1.0f)
+    {
+        memset(this, 0, sizeof(*this));
+        source = pose_source;
+        count = num_sampled;
+        motion[0] = motion0;
+        motion[1] = motion1;
+        frame[0] = frame0;
+        frame[1] = frame1;
+        percentage = blend;
+        scale = scale_factor;
+#ifndef GAME_DLL
+        serial[0] = motion0 != nullptr ? motion0->Get_Serial() : 0;
+        serial[1] = motion1 != nullptr ? motion1->Get_Serial() : 0;
+#endif
+    }
+
+    bool operator==(const PoseKeyStruct &that) const { return memcmp(this, &that, sizeof(*this)) == 0; }
+
+    uint32_t Hash() const
+    {
+        uint32_t words[sizeof(PoseKeyStruct) / sizeof(uint32_t)];
+        memcpy(words, this, sizeof(words));
+        uint32_t hash = 2166136261u;
+
+        for (size_t i = 0; i < ARRAY_SIZE(words); ++i) {
+            hash = (hash ^ words[i]) * 16777619u;
+        }
+
+        return hash;
+    }
+
+    const HAnimClass *motion[2];
+    uint32_t serial[2];
+    float frame[2];
+    float percentage;
+    float scale;
+    int32_t count;
+    int32_t source;
+};
+
+#ifndef GAME_DLL
+// Units of the same type tend to play the same animation at the same frame, synchronized marches and idle loops most of
+// all. The sampled local pose doesn't depend on the tree beyond how many pivots get sampled, so the most recently used
+// poses are kept here and every other instance only runs the hierarchy pass with its own root. Captured bones are
+// applied by that pass after the pose is read, so they never end up in a cached pose. Animations are told apart by
+// address and serial number, the serial making sure a new animation allocated where a freed one was doesn't match.
+class PoseCacheClass
+{
+public:
+    enum
+    {
+        POSE_CACHE_SIZE = 64,
+    };
+
+    PoseCacheClass() : m_tick(0)
+    {
+        memset(m_hashes, 0, sizeof(m_hashes));
+        memset(m_lastUsed, 0, sizeof(m_lastUsed));
+        memset(m_valid, 0, sizeof(m_valid));
+    }
+
+    PoseBatchClass *Find(const PoseKeyStruct &key, uint32_t hash);
+    PoseBatchClass *Insert(const PoseKeyStruct &key, uint32_t hash);
+
+private:
+    PoseBatchClass m_poses[POSE_CACHE_SIZE];
+    PoseKeyStruct m_keys[POSE_CACHE_SIZE];
+    uint32_t m_hashes[POSE_CACHE_SIZE];
+    uint32_t m_lastUsed[POSE_CACHE_SIZE];
+    bool m_valid[POSE_CACHE_SIZE];
+    uint32_t m_tick;
+};
+
+static PoseCacheClass s_poseCache;
+static bool s_poseCaching = true;
+
+PoseBatchClass *PoseCacheClass::Find(const PoseKeyStruct &key, uint32_t hash)
+{
+    for (int i = 0; i < POSE_CACHE_SIZE; ++i) {
+        if (m_valid[i] && m_hashes[i] == hash && m_keys[i] == key) {
+            m_lastUsed[i] = ++m_tick;
+            return &m_poses[i];
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Claims an empty or the least recently used entry for a pose about to be sampled.
+ */
+PoseBatchClass *PoseCacheClass::Insert(const PoseKeyStruct &key, uint32_t hash)
+{
+    int entry = 0;
+
+    for (int i = 0; i < POSE_CACHE_SIZE; ++i) {
+        if (!m_valid[i]) {
+            entry = i;
+            break;
+        }
+
+        if (m_lastUsed[i] < m_lastUsed[entry]) {
+            entry = i;
+        }
+    }
+
+    m_keys[entry] = key;
+    m_hashes[entry] = hash;
+    m_lastUsed[entry] = ++m_tick;
+    m_valid[entry] = true;
+    m_poses[entry].Reserve(key.count);
+    return &m_poses[entry];
+}
+
+void HTreeClass::Set_Pose_Caching(bool enable)
+{
+    s_poseCaching = enable;
+}
+#endif
+
+/**
+ * @brief Gets the pose for the key, cached tells whether it is already sampled or still has to be filled in.
+ */
+static PoseBatchClass *Get_Pose(const PoseKeyStruct &key, bool &cached)
+{
+#ifndef GAME_DLL
+    if (s_poseCaching) {
+        uint32_t hash = key.Hash();
+        PoseBatchClass *pose = s_poseCache.Find(key, hash);
+        cached = pose != nullptr;
+        return cached ? pose : s_poseCache.Insert(key, hash);
+    }
+#endif
+
+    cached = false;
+    s_poseBatch.Reserve(key.count);
+    return &s_poseBatch;
+}
+
+void PoseBatchClass::Free()
+{
+    for (int i = 0; i < 3; ++i) {
+        delete[] m_translation[i];
+        m_translation[i] = nullptr;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        delete[] m_rotation[i];
+        m_rotation[i] = nullptr;
+    }
+
+    for (int i = 0; i < 9; ++i) {
+        delete[] m_matrix[i];
+        m_matrix[i] = nullptr;
+    }
+
+    delete[] m_visibility;
+    delete[] m_hasRotation;
+    m_visibility = nullptr;
+    m_hasRotation = nullptr;
+    m_capacity = 0;
+}
+
+void PoseBatchClass::Reserve(int count)
+{
+    if (count <= m_capacity) {
+        return;
+    }
+
+    Free();
+
+    // Keep room for a whole trailing batch so the wide loop never needs a scalar tail.
+    int capacity = (count + POSE_BATCH_WIDTH - 1) & ~(POSE_BATCH_WIDTH - 1);
+
+    for (int i = 0; i < 3; ++i) {
+        m_translation[i] = new float[capacity];
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        m_rotation[i] = new float[capacity];
+    }
+
+    for (int i = 0; i < 9; ++i) {
+        m_matrix[i] = new float[capacity];
+    }
+
+    m_visibility = new uint8_t[capacity];
+    m_hasRotation = new uint8_t[capacity];
+    m_capacity = capacity;
+
+    // The root pivot is never sampled, start every slot off as an identity rotation so it holds sane values.
+    for (int i = 0; i < capacity; ++i) {
+        Clear_Rotation(i);
+        m_visibility[i] = POSE_VISIBILITY_UNCHANGED;
+    }
+}
+
+/**
+ * @brief Turns the first count sampled rotations into matrices with the same arithmetic as Build_Matrix3D.
+ */
+void PoseBatchClass::Build_Matrices(int count)
+{
+    int padded = (count + POSE_BATCH_WIDTH - 1) & ~(POSE_BATCH_WIDTH - 1);
+
+    for (int i = count; i < padded; ++i) {
+        m_rotation[0][i] = 0.0f;
+        m_rotation[1][i] = 0.0f;
+        m_rotation[2][i] = 0.0f;
+        m_rotation[3][i] = 1.0f;
+    }
+
+    // Build_Matrix3D widens to double but every intermediate there is exact in float except the final rounding, so
+    // these single precision versions give the same bits as long as the multiplies and adds are not fused.
+#if defined HTREE_SSE
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    for (int i = 0; i < padded; i += POSE_BATCH_WIDTH) {
+        __m128 x = _mm_loadu_ps(&m_rotation[0][i]);
+        __m128 y = _mm_loadu_ps(&m_rotation[1][i]);
+        __m128 z = _mm_loadu_ps(&m_rotation[2][i]);
+        __m128 w = _mm_loadu_ps(&m_rotation[3][i]);
+        __m128 xx = _mm_mul_ps(x, x);
+        __m128 yy = _mm_mul_ps(y, y);
+        __m128 zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y);
+        __m128 zw = _mm_mul_ps(z, w);
+        __m128 zx = _mm_mul_ps(z, x);
+        __m128 yw = _mm_mul_ps(y, w);
+        __m128 yz = _mm_mul_ps(y, z);
+        __m128 xw = _mm_mul_ps(x, w);
+        _mm_storeu_ps(&m_matrix[0][i], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+        _mm_storeu_ps(&m_matrix[1][i], _mm_mul_ps(two, _mm_sub_ps(xy, zw)));
+        _mm_storeu_ps(&m_matrix[2][i], _mm_mul_ps(two, _mm_add_ps(zx, yw)));
+        _mm_storeu_ps(&m_matrix[3][i], _mm_mul_ps(two, _mm_add_ps(xy, zw)));
+        _mm_storeu_ps(&m_matrix[4][i], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(zz, xx))));
+        _mm_storeu_ps(&m_matrix[5][i], _mm_mul_ps(two, _mm_sub_ps(yz, xw)));
+        _mm_storeu_ps(&m_matrix[6][i], _mm_mul_ps(two, _mm_sub_ps(zx, yw)));
+        _mm_storeu_ps(&m_matrix[7][i], _mm_mul_ps(two, _mm_add_ps(yz, xw)));
+        _mm_storeu_ps(&m_matrix[8][i], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, xx))));
+    }
+#elif defined HTREE_NEON
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    for (int i = 0; i < padded; i += POSE_BATCH_WIDTH) {
+        float32x4_t x = vld1q_f32(&m_rotation[0][i]);
+        float32x4_t y = vld1q_f32(&m_rotation[1][i]);
+        float32x4_t z = vld1q_f32(&m_rotation[2][i]);
+        float32x4_t w = vld1q_f32(&m_rotation[3][i]);
+        float32x4_t xx = vmulq_f32(x, x);
+        float32x4_t yy = vmulq_f32(y, y);
+        float32x4_t zz = vmulq_f32(z, z);
+        float32x4_t xy = vmulq_f32(x, y);
+        float32x4_t zw = vmulq_f32(z, w);
+        float32x4_t zx = vmulq_f32(z, x);
+        float32x4_t yw = vmulq_f32(y, w);
+        float32x4_t yz = vmulq_f32(y, z);
+        float32x4_t xw = vmulq_f32(x, w);
+        vst1q_f32(&m_matrix[0][i], vsubq_f32(one, vmulq_n_f32(vaddq_f32(yy, zz), 2.0f)));
+        vst1q_f32(&m_matrix[1][i], vmulq_n_f32(vsubq_f32(xy, zw), 2.0f));
+        vst1q_f32(&m_matrix[2][i], vmulq_n_f32(vaddq_f32(zx, yw), 2.0f));
+        vst1q_f32(&m_matrix[3][i], vmulq_n_f32(vaddq_f32(xy, zw), 2.0f));
+        vst1q_f32(&m_matrix[4][i], vsubq_f32(one, vmulq_n_f32(vaddq_f32(zz, xx), 2.0f)));
+        vst1q_f32(&m_matrix[5][i], vmulq_n_f32(vsubq_f32(yz, xw), 2.0f));
+        vst1q_f32(&m_matrix[6][i], vmulq_n_f32(vsubq_f32(zx, yw), 2.0f));
+        vst1q_f32(&m_matrix[7][i], vmulq_n_f32(vaddq_f32(yz, xw), 2.0f));
+        vst1q_f32(&m_matrix[8][i], vsubq_f32(one, vmulq_n_f32(vaddq_f32(yy, xx), 2.0f)));
+    }
+#else
+    for (int i = 0; i < padded; ++i) {
+        float x = m_rotation[0][i];
+        float y = m_rotation[1][i];
+        float z = m_rotation[2][i];
+        float w = m_rotation[3][i];
+        m_matrix[0][i] = 1.0f - 2.0f * (y * y + z * z);
+        m_matrix[1][i] = 2.0f * (x * y - z * w);
+        m_matrix[2][i] = 2.0f * (z * x + y * w);
+        m_matrix[3][i] = 2.0f * (x * y + z * w);
+        m_matrix[4][i] = 1.0f - 2.0f * (z * z + x * x);
+        m_matrix[5][i] = 2.0f * (y * z - x * w);
+        m_matrix[6][i] = 2.0f * (z * x - y * w);
+        m_matrix[7][i] = 2.0f * (y * z + x * w);
+        m_matrix[8][i] = 1.0f - 2.0f * (y * y + x * x);
+    }
+#endif
+}
+
+/**
+ * @brief Pushes the sampled pose down the hierarchy, the root pivot having been set up by the caller.
+ */
+void PoseBatchClass::Apply(PivotClass *pivots, int num_pivots, int num_anim_pivots) const
+{
+    for (int i = 1; i < num_pivots; i++) {
+        PivotClass *pivot = &pivots[i];
+        Matrix3D::Multiply(pivot->parent->transform, pivot->base_transform, &pivot->transform);
+
+        if (i < num_anim_pivots) {
+            pivot->transform.Translate(m_translation[0][i], m_translation[1][i], m_translation[2][i]);
+
+            if (m_hasRotation[i]) {
+                Matrix3D mtx(m_matrix[0][i],
+                    m_matrix[1][i],
+                    m_matrix[2][i],
+                    0.0f,
+                    m_matrix[3][i],
+                    m_matrix[4][i],
+                    m_matrix[5][i],
+                    0.0f,
+                    m_matrix[6][i],
+                    m_matrix[7][i],
+                    m_matrix[8][i],
+                    0.0f);
+                pivot->transform.Post_Mul(mtx);
+            }
+
+            if (m_visibility[i] != POSE_VISIBILITY_UNCHANGED) {
+                pivot->is_visible = m_visibility[i] == POSE_VISIBLE;
+            }
+        }
+
+        if (pivot->is_captured) {
+            pivot->Capture_Update();
+            pivot->is_visible = true;
+        }
+    }
+}
+
 HTreeClass::HTreeClass() : m_numPivots(0), m_pivot(nullptr), m_scaleFactor(1.0f)
 {
     // #BUGFIX Initialize all members
@@ -255,27 +684,25 @@ void HTreeClass::Anim_Update(Matrix3D const &root, HAnimClass *motion, float fra
     m_pivot[0].transform = root;
     m_pivot[0].is_visible = true;
     int num_anim_pivots = motion->Get_Num_Pivots();
+    int num_sampled = num_anim_pivots < m_numPivots ? num_anim_pivots : m_numPivots;
+    bool cached;
+    PoseBatchClass *pose = Get_Pose(PoseKeyStruct(POSE_SOURCE_ANIM, num_sampled, motion, frame), cached);
 
-    for (int i = 1; i < m_numPivots; i++) {
-        PivotClass *pivot = &m_pivot[i];
-        Matrix3D::Multiply(pivot->parent->transform, pivot->base_transform, &pivot->transform);
-
-        if (i < num_anim_pivots) {
+    if (!cached) {
+        for (int i = 1; i < num_sampled; i++) {
             Vector3 trans;
             motion->Get_Translation(trans, i, frame);
-            pivot->transform.Translate(trans);
+            pose->Set_Translation(i, trans.X, trans.Y, trans.Z);
             Quaternion q;
             motion->Get_Orientation(q, i, frame);
-            Matrix3D mtx = Build_Matrix3D(q);
-            pivot->transform.Post_Mul(mtx);
-            pivot->is_visible = motion->Get_Visibility(i, frame);
+            pose->Set_Rotation(i, q);
+            pose->Set_Visibility(i, motion->Get_Visibility(i, frame) ? POSE_VISIBLE : POSE_HIDDEN);
         }
 
-        if (pivot->is_captured) {
-            pivot->Capture_Update();
-            pivot->is_visible = true;
-        }
+        pose->Build_Matrices(num_sampled);
     }
+
+    pose->Apply(m_pivot, m_numPivots, num_anim_pivots);
 }
 
 void HTreeClass::Anim_Update(Matrix3D const &root, HRawAnimClass *motion, float frame)
@@ -283,6 +710,7 @@ void HTreeClass::Anim_Update(Matrix3D const &root, HRawAnimClass *motion, float
     m_pivot[0].transform = root;
     m_pivot[0].is_visible = true;
     int num_anim_pivots = motion->Get_Num_Pivots();
+    int num_sampled = num_anim_pivots < m_numPivots ? num_anim_pivots : m_numPivots;
 
     int fr = frame;
 
@@ -290,16 +718,16 @@ void HTreeClass::Anim_Update(Matrix3D const &root, HRawAnimClass *motion, float
         fr = 0;
     }
 
-    PivotClass *pivot = m_pivot;
-    NodeMotionStruct *node = &motion->Get_Node_Motion()[1];
-    PivotClass *pivot2 = &pivot[1];
-    PivotClass *pivot3 = &pivot[num_anim_pivots];
-    PivotClass *pivot4 = &pivot[m_numPivots];
+    // Raw animations don't interpolate, so every frame within the same whole frame shares one pose.
+    bool cached;
+    PoseBatchClass *pose = Get_Pose(
+        PoseKeyStruct(POSE_SOURCE_RAW_ANIM, num_sampled, motion, (float)fr, nullptr, 0.0f, 0.0f, m_scaleFactor), cached);
 
-    while (pivot2 < pivot4) {
-        Matrix3D::Multiply(pivot2->parent->transform, pivot2->base_transform, &pivot2->transform);
+    if (!cached) {
+        NodeMotionStruct *nodes = motion->Get_Node_Motion();
 
-        if (pivot2 < pivot3) {
+        for (int i = 1; i < num_sampled; i++) {
+            NodeMotionStruct *node = &nodes[i];
             float x = 0;
             float y = 0;
             float z = 0;
@@ -317,30 +745,30 @@ void HTreeClass::Anim_Update(Matrix3D const &root, HRawAnimClass *motion, float
             }
 
             if (m_scaleFactor == 1.0f) {
-                pivot2->transform.Translate(x, y, z);
+                pose->Set_Translation(i, x, y, z);
             } else {
-                pivot2->transform.Translate(x * m_scaleFactor, y * m_scaleFactor, z * m_scaleFactor);
+                pose->Set_Translation(i, x * m_scaleFactor, y * m_scaleFactor, z * m_scaleFactor);
             }
 
             if (node->Q) {
                 Quaternion q;
                 node->Q->Get_Vector_As_Quat(fr, q);
-                Matrix3D mtx = Build_Matrix3D(q);
-                pivot2->transform.Post_Mul(mtx);
+                pose->Set_Rotation(i, q);
+            } else {
+                pose->Clear_Rotation(i);
             }
 
             if (node->Vis) {
-                pivot2->is_visible = node->Vis->Get_Bit(fr) != 0;
+                pose->Set_Visibility(i, node->Vis->Get_Bit(fr) != 0 ? POSE_VISIBLE : POSE_HIDDEN);
+            } else {
+                pose->Set_Visibility(i, POSE_VISIBILITY_UNCHANGED);
             }
         }
 
-        if (pivot2->is_captured) {
-            pivot2->Capture_Update();
-            pivot2->is_visible = true;
-        }
-        pivot2++;
-        node++;
+        pose->Build_Matrices(num_sampled);
     }
+
+    pose->Apply(m_pivot, m_numPivots, num_anim_pivots);
 }
 
 void HTreeClass::Blend_Update(
@@ -354,19 +782,20 @@ void HTreeClass::Blend_Update(
         num_anim_pivots = motion1->Get_Num_Pivots();
     }
 
-    for (int i = 1; i < m_numPivots; i++) {
-        PivotClass *pivot = &m_pivot[i];
-        Matrix3D::Multiply(pivot->parent->transform, pivot->base_transform, &pivot->transform);
+    int num_sampled = num_anim_pivots < m_numPivots ? num_anim_pivots : m_numPivots;
+    bool cached;
+    PoseBatchClass *pose =
+        Get_Pose(PoseKeyStruct(POSE_SOURCE_BLEND, num_sampled, motion0, frame0, motion1, frame1, percentage), cached);
 
-        if (i < num_anim_pivots) {
+    if (!cached) {
+        for (int i = 1; i < num_sampled; i++) {
             Vector3 translation0, translation1;
             motion0->Get_Translation(translation0, i, frame0);
             motion1->Get_Translation(translation1, i, frame1);
 
             Vector3 translation;
             Vector3::Lerp(translation0, translation1, percentage, &translation);
-
-            pivot->transform.Translate(translation);
+            pose->Set_Translation(i, translation.X, translation.Y, translation.Z);
 
             Quaternion rotation0, rotation1;
             motion0->Get_Orientation(rotation0, i, frame0);
@@ -374,18 +803,16 @@ void HTreeClass::Blend_Update(
 
             Quaternion rotation;
             Fast_Slerp(rotation, rotation0, rotation1, percentage);
+            pose->Set_Rotation(i, rotation);
 
-            Matrix3D rotation_matrix = Build_Matrix3D(rotation);
-            pivot->transform.Post_Mul(rotation_matrix);
-
-            pivot->is_visible = motion0->Get_Visibility(i, frame0) || motion1->Get_Visibility(i, frame1);
+            bool visible = motion0->Get_Visibility(i, frame0) || motion1->Get_Visibility(i, frame1);
+            pose->Set_Visibility(i, visible ? POSE_VISIBLE : POSE_HIDDEN);
         }
 
-        if (pivot->is_captured) {
-            pivot->Capture_Update();
-            pivot->is_visible = true;
-        }
+        pose->Build_Matrices(num_sampled);
     }
+
+    pose->Apply(m_pivot, m_numPivots, num_anim_pivots);
 }
 
 int HTreeClass::Get_Bone_Index(char const *name)
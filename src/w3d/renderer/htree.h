@@ -83,6 +83,10 @@ public:
     const Matrix3D &Get_Root_Transform() { return m_pivot[0].transform; }
     const char *Get_Name() const { return m_name; }
 
+#ifndef GAME_DLL
+    static void Set_Pose_Caching(bool enable);
+#endif
+
     HTreeClass *Hook_Ctor() { return new (this) HTreeClass; }
     HTreeClass *Hook_Ctor2(const HTreeClass &src) { return new (this) HTreeClass(src); }
 };
@@ -14,6 +14,7 @@
  */
 #include "motchan.h"
 #include "gamemath.h"
+#include <algorithm>
 #include <cstring>
 
 using std::memcpy;
@@ -448,7 +449,9 @@ AdaptiveDeltaMotionChannelClass::AdaptiveDeltaMotionChannelClass() :
     m_scale(0.0f),
     m_data(nullptr),
     m_cacheFrame(0),
-    m_cacheData(nullptr)
+    m_cacheData(nullptr),
+    m_keyframes(nullptr),
+    m_keyframeCount(0)
 {
     if (!g_tableValid) {
         const double quarter_rot = DEG_TO_RAD(90.0);
@@ -471,9 +474,14 @@ void AdaptiveDeltaMotionChannelClass::Free()
         m_data = nullptr;
     }
     if (m_cacheData) {
-        delete m_cacheData;
+        delete[] m_cacheData;
         m_cacheData = nullptr;
     }
+    if (m_keyframes) {
+        delete[] m_keyframes;
+        m_keyframes = nullptr;
+    }
+    m_keyframeCount = 0;
 }
 
 bool AdaptiveDeltaMotionChannelClass::Load_W3D(ChunkLoadClass &cload)
@@ -500,9 +508,35 @@ bool AdaptiveDeltaMotionChannelClass::Load_W3D(ChunkLoadClass &cload)
         return false;
     }
 
+    Build_Keyframes();
     return true;
 }
 
+/**
+ * Decompressing a frame from scratch adds up the first component's deltas from frame 0, so with many units playing one
+ * animation at different frames each lookup cost time in proportion to the frame. This stores that component's value
+ * at the start of every block of deltas, worked out by the decoder's own sums so that carrying on from one is bit for
+ * bit the same as starting from frame 0.
+ */
+void AdaptiveDeltaMotionChannelClass::Build_Keyframes()
+{
+    float src[4];
+    float out[4];
+
+    captainslog_assert(m_vectorLen <= 4);
+
+    m_keyframeCount = m_numFrames > 1 ? (m_numFrames - 2) / DELTAS_PER_BLOCK + 1 : 1;
+    m_keyframes = new float[m_keyframeCount];
+    memcpy(src, m_data, 4 * m_vectorLen);
+    m_keyframes[0] = src[0];
+
+    for (unsigned int key = 1; key < m_keyframeCount; ++key) {
+        Decompress((key - 1) * DELTAS_PER_BLOCK, src, key * DELTAS_PER_BLOCK, out);
+        m_keyframes[key] = out[0];
+        src[0] = out[0];
+    }
+}
+
 void AdaptiveDeltaMotionChannelClass::Get_Vector(float frame, float *setvec)
 {
     float value1 = AdaptiveDeltaMotionChannelClass::Get_Frame(frame, 0);
@@ -550,7 +584,7 @@ float AdaptiveDeltaMotionChannelClass::Get_Frame(unsigned int frame_idx, unsigne
         return m_cacheData[vector_idx + m_vectorLen];
     } else {
 
-        captainslog_assert(m_vectorLen < 4);
+        captainslog_assert(m_vectorLen <= 4);
 
         memcpy(dst, &m_cacheData[m_vectorLen], 4 * m_vectorLen);
         Decompress(m_cacheFrame, dst, frame_idx, m_cacheData);
@@ -635,6 +669,16 @@ void AdaptiveDeltaMotionChannelClass::Decompress(unsigned int frame_idx, float *
         float *f1 = (float *)((char *)m_data + 9 * i + 4 * m_vectorLen);
         float f2 = srcdata[i];
         unsigned int i1 = 1;
+
+        if (i == 0 && frame_idx > DELTAS_PER_BLOCK) {
+            // Only the first component runs on past its first block, the done flag stops the others there. Starting it
+            // from the keyframe of the block holding the last delta still leaves that delta to set the flag.
+            unsigned int key = std::min((frame_idx - 1) / DELTAS_PER_BLOCK, m_keyframeCount - 1);
+            f1 = (float *)((char *)f1 + key * 9 * m_vectorLen);
+            f2 = m_keyframes[key];
+            i1 = key * DELTAS_PER_BLOCK + 1;
+        }
+
         while (i1 <= frame_idx) {
             int i2 = *(char *)f1;
             float *f3 = (float *)((char *)f1 + 1);
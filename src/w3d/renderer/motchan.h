@@ -178,6 +178,13 @@ public:
     void Decompress(unsigned int frame_idx, float *outdata);
 
 private:
+    enum
+    {
+        DELTAS_PER_BLOCK = 16,
+    };
+
+    void Build_Keyframes();
+
     unsigned int m_pivotIdx;
     unsigned int m_type;
     int m_vectorLen;
@@ -186,4 +193,7 @@ private:
     unsigned int *m_data;
     unsigned int m_cacheFrame;
     float *m_cacheData;
+    // Value of the first component at the start of every delta block.
+    float *m_keyframes;
+    unsigned int m_keyframeCount;
 };
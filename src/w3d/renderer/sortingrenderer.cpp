@@ -13,13 +13,13 @@
  *            LICENSE
  */
 #include "sortingrenderer.h"
+#include "depthsort.h"
 #include "dllist.h"
 #include "dx8indexbuffer.h"
 #include "dx8vertexbuffer.h"
 #include "dx8wrapper.h"
 #include "sphere.h"
 #include "w3d.h"
-#include <algorithm>
 #ifdef BUILD_WITH_D3D8
 #include <d3dx8.h>
 #endif
@@ -77,6 +77,11 @@ static unsigned int g_totalSortingVertices;
 static DLListClass<SortingNodeStruct> g_cleanList;
 static DLListClass<SortingNodeStruct> g_sortedList;
 
+static SortingNodeStruct **g_sortNodeArray;
+static unsigned int g_sortNodeArrayCount;
+static DepthSortClass g_nodeDepthSort;
+static DepthSortClass g_polygonDepthSort;
+
 bool operator<(TempIndexStruct const &left, TempIndexStruct const &right)
 {
     return left.z < right.z;
@@ -128,75 +133,6 @@ void Release_Refs(SortingNodeStruct *state)
     }
 }
 
-// void InsertionSort(TempIndexStruct *begin, TempIndexStruct *end)
-//{
-//    /* This is a stripped down __insertion_sort from stl */
-//    for (auto iter = begin + 1; iter < end; ++iter) {
-//        /* This is __unguarded_linear_insert from stl */
-//        auto val = *iter;
-//        auto *next = iter - 1;
-//        auto *cur = iter;
-//        while (*next > val) {
-//            *cur = *next;
-//            cur = next;
-//            --next;
-//        }
-//        *cur = val;
-//    }
-//}
-
-// zh: 0x0080D3C0 wb: 0x0056A9A0
-void Sort(TempIndexStruct *begin, TempIndexStruct *end)
-{
-    std::sort(begin, end);
-    // Vanilla used a specialised sort see below
-    /*
-    // 16 is the __stl_threshold
-    for (auto total_elements = end - begin; total_elements > 16; total_elements = end - begin) {
-        auto *halfway = &begin[total_elements / 2];
-        auto *next = begin + 1; // ebx
-        auto *last = end - 1;
-        std::swap(*halfway, *next);
-        if (*next > *last) {
-            std::swap(*next, *last);
-        }
-        if (*begin > *last) {
-            std::swap(*begin, *last);
-        }
-        if (*next > *begin) {
-            std::swap(*next, *begin);
-        }
-
-        auto *ptr = next; // ebp
-        auto *pivot = last; // esi
-        while (1) {
-            while (++ptr <= last && *ptr < *begin)
-                ;
-            while (--pivot > next && *pivot > *begin)
-                ;
-
-            if (pivot < ptr) {
-                break;
-            }
-            std::swap(*ptr, *pivot);
-        }
-
-        std::swap(*pivot, *begin);
-
-        auto right_num_elements = end - pivot - 1;
-        auto left_num_elements = pivot - begin;
-        // Sort the smallest side
-        if (left_num_elements <= right_num_elements) {
-            Sort(begin, pivot);
-            begin = pivot + 1;
-        } else {
-            Sort(pivot + 1, end);
-            end = pivot;
-        }
-    }
-    InsertionSort(begin, end);*/
-}
-
 TempIndexStruct *Get_Temp_Index_Array(unsigned int count)
 {
     if (count < g_defaultSortingPolyCount) {
@@ -212,6 +148,17 @@ TempIndexStruct *Get_Temp_Index_Array(unsigned int count)
     return g_tempIndexArray;
 }
 
+SortingNodeStruct **Get_Sort_Node_Array(unsigned int count)
+{
+    if (count > g_sortNodeArrayCount) {
+        delete[] g_sortNodeArray;
+        g_sortNodeArray = new SortingNodeStruct *[count];
+        g_sortNodeArrayCount = count;
+    }
+
+    return g_sortNodeArray;
+}
+
 void Apply_Render_State(RenderStateStruct &render_state)
 {
     DX8Wrapper::Set_Shader(render_state.shader);
@@ -282,22 +229,7 @@ void SortingRendererClass::Insert_Triangles(const SphereClass &bounding_sphere,
         state->transformed_center.Y = transformed_center.y;
         state->transformed_center.Z = transformed_center.z;
 
-        SortingNodeStruct *i;
-
-        for (i = g_sortedList.Head(); i; i = i->Succ()) {
-            if (state->transformed_center.Z > i->transformed_center.Z) {
-                if (g_sortedList.Head() == g_sortedList.Tail()) {
-                    g_sortedList.Add_Head(state);
-                } else {
-                    state->Insert_Before(i);
-                }
-                break;
-            }
-        }
-
-        if (!i) {
-            g_sortedList.Add_Tail(state);
-        }
+        g_sortedList.Add_Tail(state);
     } else {
         DX8Wrapper::Draw_Triangles(start_index, polygon_count, min_vertex_index, vertex_count);
     }
@@ -439,7 +371,14 @@ void SortingRendererClass::Flush_Sorting_Pool()
             }
         }
 
-        Sort(index_array, &index_array[g_overlappingPolygonCount]);
+        // Ascending z as the comparison sort ordered them, equal z now keeping the order the nodes were pooled in.
+        uint32_t *keys = g_polygonDepthSort.Get_Key_Array(g_overlappingPolygonCount);
+
+        for (unsigned int i = 0; i < g_overlappingPolygonCount; i++) {
+            keys[i] = DepthSortClass::Ascending_Key(index_array[i].z);
+        }
+
+        const uint32_t *order = g_polygonDepthSort.Sort(g_overlappingPolygonCount);
         unsigned int polygonAllocCount = g_overlappingPolygonCount;
 
         if (DynamicIBAccessClass::Get_Default_Index_Count() / 3u < g_defaultSortingPolyCount) {
@@ -457,9 +396,10 @@ void SortingRendererClass::Flush_Sorting_Pool()
             DynamicIBAccessClass::WriteLockClass lock(&dyn_ib_access);
             unsigned short *dest_indices = lock.Get_Index_Array();
             for (unsigned int i = 0; i < g_overlappingPolygonCount; i++) {
-                dest_indices[3 * i] = index_array[i].tri.i;
-                dest_indices[3 * i + 1] = index_array[i].tri.j;
-                dest_indices[3 * i + 2] = index_array[i].tri.k;
+                const TempIndexStruct &tis = index_array[order[i]];
+                dest_indices[3 * i] = tis.tri.i;
+                dest_indices[3 * i + 1] = tis.tri.j;
+                dest_indices[3 * i + 2] = tis.tri.k;
             }
         }
 
@@ -468,10 +408,10 @@ void SortingRendererClass::Flush_Sorting_Pool()
         DX8Wrapper::Apply_Render_State_Changes();
         int polygon_count = 1;
         unsigned short start_index = 0;
-        unsigned int idx = index_array->idx;
+        unsigned int idx = index_array[order[0]].idx;
 
         for (unsigned int i = 1; i < g_overlappingPolygonCount; i++) {
-            if (idx != index_array[i].idx) {
+            if (idx != index_array[order[i]].idx) {
                 Apply_Render_State(g_overlappingNodes[idx]->sorting_state);
                 DX8Wrapper::Draw_Triangles(3 * start_index,
                     polygon_count,
@@ -479,7 +419,7 @@ void SortingRendererClass::Flush_Sorting_Pool()
                     g_overlappingNodes[idx]->vertex_count);
                 start_index = i;
                 polygon_count = 0;
-                idx = index_array[i].idx;
+                idx = index_array[order[i]].idx;
             }
 
             polygon_count++;
@@ -513,13 +453,29 @@ void SortingRendererClass::Flush()
     DX8Wrapper::Get_Transform(D3DTS_VIEW, old_view);
     DX8Wrapper::Get_Transform(D3DTS_WORLD, old_world);
 
-    for (;;) {
-        SortingNodeStruct *state = g_sortedList.Head();
+    // Nodes are added to the sorted list as they arrive and put in order here once per flush. The list used to be kept
+    // ordered on every insert, which made a frame full of smoke and explosions quadratic in its node count. Nodes still
+    // come out by descending view space z and nodes at the same z keep the order they were inserted in.
+    unsigned int node_count = 0;
 
-        if (!state) {
-            break;
-        }
+    for (SortingNodeStruct *i = g_sortedList.Head(); i; i = i->Succ()) {
+        node_count++;
+    }
 
+    SortingNodeStruct **nodes = Get_Sort_Node_Array(node_count);
+    uint32_t *keys = g_nodeDepthSort.Get_Key_Array(node_count);
+    unsigned int node_id = 0;
+
+    for (SortingNodeStruct *i = g_sortedList.Head(); i; i = i->Succ()) {
+        nodes[node_id] = i;
+        keys[node_id] = DepthSortClass::Descending_Key(i->transformed_center.Z);
+        node_id++;
+    }
+
+    const uint32_t *order = g_nodeDepthSort.Sort(node_count);
+
+    for (unsigned int i = 0; i < node_count; i++) {
+        SortingNodeStruct *state = nodes[order[i]];
         state->Remove();
 
         if ((state->sorting_state.index_buffer_type == IndexBufferClass::BUFFER_TYPE_SORTING
@@ -571,4 +527,10 @@ void SortingRendererClass::Deinit()
     delete[] g_tempIndexArray;
     g_tempIndexArray = nullptr;
     g_tempIndexArrayCount = 0;
+
+    delete[] g_sortNodeArray;
+    g_sortNodeArray = nullptr;
+    g_sortNodeArrayCount = 0;
+    g_nodeDepthSort.Free();
+    g_polygonDepthSort.Free();
 }
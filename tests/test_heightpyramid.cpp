@@ -0,0 +1,112 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for the block height ranges kept over terrain height maps.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <heightpyramid.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+void Brute_Force_Range(const std::vector<unsigned char> &data,
+    int width,
+    int height,
+    int x0,
+    int y0,
+    int x1,
+    int y1,
+    unsigned char &min_height,
+    unsigned char &max_height)
+{
+    min_height = 255;
+    max_height = 0;
+
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            unsigned char value = data[std::clamp(x, 0, width - 1) + width * std::clamp(y, 0, height - 1)];
+            min_height = std::min(min_height, value);
+            max_height = std::max(max_height, value);
+        }
+    }
+}
+} // namespace
+
+TEST(heightpyramid, ranges_match_brute_force)
+{
+    std::mt19937 rng(1234);
+    const int sizes[][2] = { { 1, 1 }, { 2, 7 }, { 33, 17 }, { 100, 129 } };
+
+    for (const auto &size : sizes) {
+        int width = size[0];
+        int height = size[1];
+        std::vector<unsigned char> data(width * height);
+
+        for (unsigned char &value : data) {
+            value = rng() % 256;
+        }
+
+        HeightPyramidClass pyramid;
+        pyramid.Build(data.data(), width, height);
+        EXPECT_EQ(pyramid.Get_Level_Width(pyramid.Get_Level_Count() - 1), 1);
+        EXPECT_EQ(pyramid.Get_Level_Height(pyramid.Get_Level_Count() - 1), 1);
+
+        for (int i = 0; i < 2000; i++) {
+            // Lower some heights the way terrain deformation does, and raise others.
+            if (i % 10 == 0) {
+                int x = rng() % width;
+                int y = rng() % height;
+                data[x + width * y] = rng() % 256;
+                pyramid.Update(x, y);
+            }
+
+            int x0 = int(rng() % (width + 8)) - 4;
+            int y0 = int(rng() % (height + 8)) - 4;
+            int x1 = x0 + int(rng() % (width + 4));
+            int y1 = y0 + int(rng() % (height + 4));
+            unsigned char min_height;
+            unsigned char max_height;
+            unsigned char expected_min;
+            unsigned char expected_max;
+            pyramid.Get_Range(x0, y0, x1, y1, min_height, max_height);
+            Brute_Force_Range(data, width, height, x0, y0, x1, y1, expected_min, expected_max);
+            EXPECT_EQ(min_height, expected_min);
+            EXPECT_EQ(max_height, expected_max);
+
+            if (width > 1 && height > 1) {
+                int level = rng() % pyramid.Get_Level_Count();
+                int cell_x = rng() % (width - 1);
+                int cell_y = rng() % (height - 1);
+                int block_x = (cell_x >> level) << level;
+                int block_y = (cell_y >> level) << level;
+                int block_cells = 1 << level;
+                Brute_Force_Range(data,
+                    width,
+                    height,
+                    block_x,
+                    block_y,
+                    std::min(block_x + block_cells, width - 1),
+                    std::min(block_y + block_cells, height - 1),
+                    expected_min,
+                    expected_max);
+                unsigned char block_max = pyramid.Get_Cell_Block_Max(level, cell_x, cell_y);
+                EXPECT_GE(block_max, expected_max);
+
+                if (level == 0) {
+                    EXPECT_EQ(block_max, expected_max);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for the buffer of hits remembered for a weapon's historic bonus.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <deque>
+#include <gtest/gtest.h>
+#include <random>
+#include <weapon.h>
+
+namespace
+{
+HistoricWeaponDamageInfo Make_Hit(unsigned int frame, float x, float y)
+{
+    Coord3D loc;
+    loc.x = x;
+    loc.y = y;
+    loc.z = 0.0f;
+    return HistoricWeaponDamageInfo(frame, loc);
+}
+
+// What WeaponTemplate::Deal_Damage_Internal counted before the buffer, a walk over every remembered hit.
+int List_Count(
+    const std::deque<HistoricWeaponDamageInfo> &hits, const Coord3D &pos, float radius, unsigned int since_frame)
+{
+    int count = 0;
+
+    for (const HistoricWeaponDamageInfo &info : hits) {
+        float dx = pos.x - info.location.x;
+        float dy = pos.y - info.location.y;
+
+        if (info.frame >= since_frame && dx * dx + dy * dy <= radius * radius) {
+            count++;
+        }
+    }
+
+    return count;
+}
+} // namespace
+
+TEST(historicdamage, matches_list_walk)
+{
+    std::mt19937 rng(1618);
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    std::uniform_int_distribution<int> action(0, 9);
+    const float radii[] = { 0.0f, 5.0f, 50.0f, 2000.0f };
+
+    for (float radius : radii) {
+        HistoricDamageBuffer buffer;
+        std::deque<HistoricWeaponDamageInfo> hits;
+        unsigned int frame = 0;
+
+        for (int i = 0; i < 5000; i++) {
+            int what = action(rng);
+            frame += what == 0 ? 1 : 0;
+
+            if (what < 6) {
+                HistoricWeaponDamageInfo info = Make_Hit(frame, coord(rng), coord(rng));
+                buffer.Add(info, radius);
+                hits.push_back(info);
+            } else if (what == 6 && frame > 20) {
+                buffer.Trim(frame - 20);
+
+                while (!hits.empty() && hits.front().frame <= frame - 20) {
+                    hits.pop_front();
+                }
+            } else {
+                Coord3D pos = Make_Hit(0, coord(rng), coord(rng)).location;
+                unsigned int since = frame > 10 ? frame - 10 : 0;
+                EXPECT_EQ(buffer.Count_Near(pos, radius, since), List_Count(hits, pos, radius, since));
+            }
+
+            EXPECT_EQ(buffer.Get_Count(), (int)hits.size());
+        }
+    }
+}
+
+TEST(historicdamage, full_buffer_grows)
+{
+    HistoricDamageBuffer buffer;
+    const int total = HistoricDamageBuffer::INITIAL_CAPACITY * 5 + 3;
+
+    // Every hit on its own spot so which ones are remembered can be told apart.
+    for (int i = 0; i < total; i++) {
+        buffer.Add(Make_Hit(i, i * 100.0f, 0.0f), 10.0f);
+    }
+
+    EXPECT_EQ(buffer.Get_Count(), total);
+
+    for (int i = 0; i < total; i++) {
+        EXPECT_EQ(buffer.Count_Near(Make_Hit(0, i * 100.0f, 0.0f).location, 1.0f, 0), 1);
+    }
+
+    Coord3D middle = Make_Hit(0, total * 50.0f, 0.0f).location;
+    EXPECT_EQ(buffer.Count_Near(middle, 1.0e6f, 0), total);
+
+    // Growing while the remembered hits wrap around the end of the ring keeps them in order.
+    buffer.Trim(total - HistoricDamageBuffer::INITIAL_CAPACITY * 3);
+    int kept = buffer.Get_Count();
+
+    for (int i = 0; i < HistoricDamageBuffer::INITIAL_CAPACITY * 8; i++) {
+        buffer.Add(Make_Hit(total + i, 0.0f, 0.0f), 10.0f);
+    }
+
+    EXPECT_EQ(buffer.Get_Count(), kept + HistoricDamageBuffer::INITIAL_CAPACITY * 8);
+    EXPECT_EQ(buffer.Count_Near(middle, 1.0e6f, 0), buffer.Get_Count());
+    EXPECT_EQ(buffer.Count_Near(middle, 1.0e6f, total), HistoricDamageBuffer::INITIAL_CAPACITY * 8);
+    EXPECT_EQ(buffer.Count_Near(Make_Hit(0, 100.0f * (total - 1), 0.0f).location, 1.0f, 0), 1);
+    EXPECT_EQ(buffer.Count_Near(Make_Hit(0, 100.0f * (total - kept - 1), 0.0f).location, 1.0f, 0), 0);
+
+    // Expiring in frame order still works across the grown ring.
+    buffer.Trim(total - 1);
+    EXPECT_EQ(buffer.Get_Count(), HistoricDamageBuffer::INITIAL_CAPACITY * 8);
+}
+
+TEST(historicdamage, trim_expires_old_hits)
+{
+    HistoricDamageBuffer buffer;
+    Coord3D origin = Make_Hit(0, 0.0f, 0.0f).location;
+    EXPECT_EQ(buffer.Count_Near(origin, 10.0f, 0), 0);
+    const int capacity = HistoricDamageBuffer::INITIAL_CAPACITY;
+
+    // Fill the ring, expire half of it and refill so the remembered hits wrap around its end without it growing.
+    for (int i = 0; i < capacity; i++) {
+        buffer.Add(Make_Hit(i / 4, 0.0f, 0.0f), 10.0f);
+    }
+
+    buffer.Trim(capacity / 8 - 1);
+    EXPECT_EQ(buffer.Get_Count(), capacity / 2);
+
+    for (int i = capacity; i < capacity + capacity / 2; i++) {
+        buffer.Add(Make_Hit(i / 4, 0.0f, 0.0f), 10.0f);
+    }
+
+    int first_frame = capacity / 8;
+    EXPECT_EQ(buffer.Count_Near(origin, 10.0f, 0), capacity);
+
+    buffer.Trim(first_frame);
+    EXPECT_EQ(buffer.Get_Count(), capacity - 4);
+    EXPECT_EQ(buffer.Count_Near(origin, 10.0f, 0), capacity - 4);
+
+    // Hits are only counted from the frame asked for even when older ones are still remembered.
+    EXPECT_EQ(buffer.Count_Near(origin, 10.0f, first_frame + 2), capacity - 8);
+
+    buffer.Trim(100000);
+    EXPECT_EQ(buffer.Get_Count(), 0);
+    EXPECT_EQ(buffer.Count_Near(origin, 10.0f, 0), 0);
+
+    buffer.Add(Make_Hit(100001, 0.0f, 0.0f), 10.0f);
+    EXPECT_EQ(buffer.Get_Count(), 1);
+    EXPECT_EQ(buffer.Count_Near(origin, 10.0f, 0), 1);
+
+    buffer.Clear();
+    EXPECT_EQ(buffer.Get_Count(), 0);
+    EXPECT_EQ(buffer.Count_Near(origin, 10.0f, 0), 0);
+}
@@ -0,0 +1,340 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for the particle system manager.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <archivefilesystem.h>
+#include <filesystem.h>
+#include <gameclient.h>
+#include <gamelod.h>
+#include <globaldata.h>
+#include <gtest/gtest.h>
+#include <ini.h>
+#include <localfilesystem.h>
+#include <particle.h>
+#include <particlesys.h>
+#include <particlesysmanager.h>
+#include <particlesystemplate.h>
+#include <randomvalue.h>
+#include <vector>
+#include <win32localfilesystem.h>
+
+namespace
+{
+class FakeGameClient : public GameClient
+{
+public:
+    virtual void Create_Ray_Effect_From_Template(const Coord3D *src, const Coord3D *dst, const ThingTemplate *temp) override
+    {
+    }
+    virtual void Add_Scorch(Coord3D *pos, float scale, Scorches scorch) override {}
+    virtual Drawable *Create_Drawable(const ThingTemplate *temp, DrawableStatus status) override { return nullptr; }
+    virtual void Set_Team_Color(int red, int blue, int green) override {}
+    virtual void Adjust_LOD(int lod) override {}
+    virtual void Notify_Terrain_Object_Moved(Object *obj) override {}
+    virtual Display *Create_GameDisplay() override { return nullptr; }
+    virtual InGameUI *Create_InGameUI() override { return nullptr; }
+    virtual GameWindowManager *Create_WindowManager() override { return nullptr; }
+    virtual FontLibrary *Create_FontLibrary() override { return nullptr; }
+    virtual DisplayStringManager *Create_DisplayStringManager() override { return nullptr; }
+    virtual VideoPlayer *Create_VideoPlayer() override { return nullptr; }
+    virtual TerrainVisual *Create_TerrainVisual() override { return nullptr; }
+    virtual Keyboard *Create_Keyboard() override { return nullptr; }
+    virtual Mouse *Create_Mouse() override { return nullptr; }
+    virtual SnowManager *Create_SnowManager() override { return nullptr; }
+    virtual void Set_Frame_Rate(float fps) override {}
+};
+
+class FakeParticleSystemManager : public ParticleSystemManager
+{
+public:
+    virtual int Get_On_Screen_Particle_Count() override { return 0; }
+    virtual void Do_Particles(RenderInfoClass &rinfo) override {}
+    virtual void Queue_Particle_Render() override {}
+
+    using ParticleSystemManager::Update_Parallel;
+
+    // Fixes the worker count so the workers run even where the hardware would update serially.
+    void Set_Update_Worker_Count(int count) { m_updateWorkerCount = count; }
+
+    // The system loop of Update when m_serialUpdate is set, without the game logic frame check.
+    void Update_Serial()
+    {
+        for (auto it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end();) {
+            ParticleSystem *system = *it;
+            it++;
+
+            if (system != nullptr && !system->Update(m_playerIndex)) {
+                system->Delete_Instance();
+            }
+        }
+    }
+};
+
+void Expect_Same_Particles(const ParticleSystem *a, const ParticleSystem *b)
+{
+    ASSERT_EQ(a->Get_Particle_Count(), b->Get_Particle_Count());
+    const Particle *pa = a->Get_First_Particle();
+    const Particle *pb = b->Get_First_Particle();
+
+    for (; pa != nullptr && pb != nullptr; pa = pa->Get_System_Next(), pb = pb->Get_System_Next()) {
+        EXPECT_EQ(pa->Get_Position()->x, pb->Get_Position()->x);
+        EXPECT_EQ(pa->Get_Position()->y, pb->Get_Position()->y);
+        EXPECT_EQ(pa->Get_Position()->z, pb->Get_Position()->z);
+        EXPECT_EQ(pa->Get_Size(), pb->Get_Size());
+        EXPECT_EQ(pa->Get_Angle(), pb->Get_Angle());
+        EXPECT_EQ(pa->Get_Alpha(), pb->Get_Alpha());
+        EXPECT_EQ(pa->Get_Color()->red, pb->Get_Color()->red);
+        EXPECT_EQ(pa->Get_Color()->green, pb->Get_Color()->green);
+        EXPECT_EQ(pa->Get_Color()->blue, pb->Get_Color()->blue);
+    }
+
+    EXPECT_EQ(pa, nullptr);
+    EXPECT_EQ(pb, nullptr);
+}
+
+// Everything about the systems of a manager that an update changes, in list order.
+std::vector<float> Capture_Systems(ParticleSystemManager *manager)
+{
+    std::vector<float> state;
+
+    for (const ParticleSystem *system : manager->Get_All_Particle_Systems()) {
+        state.push_back((float)system->Get_System_ID());
+        state.push_back(system->Get_Master() != nullptr ? (float)system->Get_Master()->Get_System_ID() : -1.0f);
+        state.push_back((float)system->Get_Particle_Count());
+
+        for (const Particle *particle = system->Get_First_Particle(); particle != nullptr;
+             particle = particle->Get_System_Next()) {
+            state.push_back(particle->Get_Position()->x);
+            state.push_back(particle->Get_Position()->y);
+            state.push_back(particle->Get_Position()->z);
+            state.push_back(particle->Get_Size());
+            state.push_back(particle->Get_Angle());
+            state.push_back(particle->Get_Alpha());
+        }
+    }
+
+    return state;
+}
+} // namespace
+
+class ParticleSystemTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp() override
+    {
+        // GlobalData and the INI loader both go through the file system, so give them one that only sees local files.
+        m_localFileSystem = new Win32LocalFileSystem();
+        g_theLocalFileSystem = m_localFileSystem;
+        g_theArchiveFileSystem = nullptr;
+        m_fileSystem = new FileSystem();
+        g_theFileSystem = m_fileSystem;
+        m_globalData = new GlobalData();
+        g_theWriteableGlobalData = m_globalData;
+        m_globalData->m_maxParticleCount = 100000;
+        m_client = new FakeGameClient();
+        g_theGameClient = m_client;
+        m_lod = new GameLODManager();
+        g_theGameLODManager = m_lod;
+        m_manager = new FakeParticleSystemManager();
+        g_theParticleSystemManager = m_manager;
+
+        INI ini;
+        ini.Load(Utf8String(TESTDATA_PATH) + "/particlesys/particlesys.ini", INI_LOAD_OVERWRITE, nullptr);
+    }
+
+    virtual void TearDown() override
+    {
+        delete m_manager;
+        g_theParticleSystemManager = nullptr;
+        delete m_lod;
+        g_theGameLODManager = nullptr;
+        delete m_client;
+        g_theGameClient = nullptr;
+        delete m_globalData;
+        g_theWriteableGlobalData = nullptr;
+        delete m_fileSystem;
+        g_theFileSystem = nullptr;
+        delete m_localFileSystem;
+        g_theLocalFileSystem = nullptr;
+    }
+
+    // Creates a system that emits one burst and then stops, so only the stepping of its particles changes it.
+    ParticleSystem *Emit_Burst(ParticleSystemTemplate *tmplate)
+    {
+        ParticleSystem *system = m_manager->Create_Particle_System(tmplate, false);
+        bool keep_alive;
+        system->Update_Emission(0, keep_alive);
+        system->Stop();
+        return system;
+    }
+
+    Win32LocalFileSystem *m_localFileSystem;
+    FileSystem *m_fileSystem;
+    GlobalData *m_globalData;
+    FakeGameClient *m_client;
+    GameLODManager *m_lod;
+    FakeParticleSystemManager *m_manager;
+};
+
+TEST_F(ParticleSystemTest, find_by_id)
+{
+    ParticleSystemTemplate *tmplate = m_manager->Find_Template("Smoke");
+    std::vector<ParticleSystem *> systems;
+
+    for (int i = 0; i < 50; i++) {
+        systems.push_back(m_manager->Create_Particle_System(tmplate, false));
+    }
+
+    for (ParticleSystem *system : systems) {
+        EXPECT_EQ(m_manager->Find_Particle_System(system->Get_System_ID()), system);
+    }
+
+    EXPECT_EQ(m_manager->Find_Particle_System(PARTSYS_ID_NONE), nullptr);
+    EXPECT_EQ(m_manager->Find_Particle_System(ParticleSystemID(1000)), nullptr);
+
+    // Deleted systems are no longer found and the others are unaffected.
+    for (size_t i = 0; i < systems.size(); i += 3) {
+        ParticleSystemID id = systems[i]->Get_System_ID();
+        systems[i]->Delete_Instance();
+        EXPECT_EQ(m_manager->Find_Particle_System(id), nullptr);
+        systems[i] = nullptr;
+    }
+
+    for (ParticleSystem *system : systems) {
+        if (system != nullptr) {
+            EXPECT_EQ(m_manager->Find_Particle_System(system->Get_System_ID()), system);
+        }
+    }
+
+    // A system that is only flagged as destroyed stays findable until it is deleted.
+    ParticleSystemID id = systems[1]->Get_System_ID();
+    m_manager->Destroy_Particle_System_By_ID(id);
+    EXPECT_EQ(m_manager->Find_Particle_System(id), systems[1]);
+    EXPECT_TRUE(systems[1]->Is_Destroyed());
+
+    m_manager->Reset();
+    EXPECT_EQ(m_manager->Get_Particle_System_Count(), 0u);
+
+    for (int i = 1; i <= 50; i++) {
+        EXPECT_EQ(m_manager->Find_Particle_System(ParticleSystemID(i)), nullptr);
+    }
+
+    // Ids start over after a reset and must find the new systems rather than anything left from before.
+    ParticleSystem *fresh = m_manager->Create_Particle_System(tmplate, false);
+    EXPECT_EQ(fresh->Get_System_ID(), ParticleSystemID(1));
+    EXPECT_EQ(m_manager->Find_Particle_System(ParticleSystemID(1)), fresh);
+}
+
+TEST_F(ParticleSystemTest, find_slave_systems)
+{
+    ParticleSystemTemplate *master_template = m_manager->Find_Template("Fire");
+
+    ParticleSystem *master = m_manager->Create_Particle_System(master_template, true);
+    ASSERT_NE(master->Get_Slave(), nullptr);
+    const ParticleSystem *slave = master->Get_Slave();
+    EXPECT_EQ(m_manager->Find_Particle_System(master->Get_System_ID()), master);
+    EXPECT_EQ(m_manager->Find_Particle_System(slave->Get_System_ID()), slave);
+    EXPECT_NE(master->Get_System_ID(), slave->Get_System_ID());
+
+    ParticleSystemID slave_id = slave->Get_System_ID();
+    master->Delete_Instance();
+    ParticleSystem *found = m_manager->Find_Particle_System(slave_id);
+    ASSERT_EQ(found, slave);
+    EXPECT_EQ(found->Get_Master(), nullptr);
+}
+
+TEST_F(ParticleSystemTest, destroy_attached_systems_without_object)
+{
+    ParticleSystemTemplate *tmplate = m_manager->Find_Template("Smoke");
+    ParticleSystem *system = m_manager->Create_Particle_System(tmplate, false);
+
+    m_manager->Destroy_Attached_Systems(nullptr);
+    EXPECT_FALSE(system->Is_Destroyed());
+
+    // Attaching to nothing leaves the system out of the per object lists.
+    system->Attach_To_Object(nullptr);
+    EXPECT_EQ(system->Get_Attached_Object(), INVALID_OBJECT_ID);
+    EXPECT_EQ(m_manager->Find_Particle_System(system->Get_System_ID()), system);
+}
+
+TEST_F(ParticleSystemTest, deferred_expiry_matches_immediate)
+{
+    ParticleSystemTemplate *tmplate = m_manager->Find_Template("Sparks");
+
+    // The same seed gives both systems the same particles.
+    Init_Random(4242);
+    ParticleSystem *immediate = Emit_Burst(tmplate);
+    Init_Random(4242);
+    ParticleSystem *deferred = Emit_Burst(tmplate);
+    ASSERT_EQ(immediate->Get_Particle_Count(), 200u);
+    Expect_Same_Particles(immediate, deferred);
+
+    std::vector<Particle *> expired;
+    size_t total_expired = 0;
+
+    for (unsigned int frame = 1; frame <= 70; frame++) {
+        m_client->Set_Frame(frame);
+        immediate->Update_Particles(nullptr);
+        expired.clear();
+        deferred->Update_Particles(&expired);
+
+        // Expired particles stay in the system until the caller deletes them.
+        EXPECT_EQ(deferred->Get_Particle_Count(), immediate->Get_Particle_Count() + expired.size());
+        total_expired += expired.size();
+
+        for (Particle *particle : expired) {
+            particle->Delete_Instance();
+        }
+
+        Expect_Same_Particles(immediate, deferred);
+    }
+
+    EXPECT_EQ(total_expired, 200u);
+    EXPECT_EQ(immediate->Get_Particle_Count(), 0u);
+}
+
+TEST_F(ParticleSystemTest, parallel_update_matches_serial)
+{
+    // Masters that emit for a while and then die, after which their slaves carry on emitting on their own.
+    ParticleSystemTemplate *sparks = m_manager->Find_Template("SparkShower");
+    ParticleSystemTemplate *embers = m_manager->Find_Template("Embers");
+    m_manager->Set_Update_Worker_Count(ParticleSystemManager::MAX_UPDATE_WORKERS);
+
+    std::vector<std::vector<float>> serial_frames;
+
+    for (int pass = 0; pass < 2; pass++) {
+        m_manager->Reset();
+        Init_Random(777);
+
+        for (int i = 0; i < 8; i++) {
+            m_manager->Create_Particle_System(i % 2 == 0 ? sparks : embers, true);
+        }
+
+        ASSERT_EQ(m_manager->Get_Particle_System_Count(), 12u);
+
+        for (unsigned int frame = 1; frame <= 110; frame++) {
+            m_client->Set_Frame(frame);
+
+            if (pass == 0) {
+                m_manager->Update_Serial();
+                serial_frames.push_back(Capture_Systems(m_manager));
+            } else {
+                m_manager->Update_Parallel();
+                ASSERT_EQ(Capture_Systems(m_manager), serial_frames[frame - 1]) << "frame " << frame;
+            }
+        }
+
+        // Only the masters are gone by the end.
+        EXPECT_EQ(m_manager->Get_Particle_System_Count(), 8u);
+    }
+}
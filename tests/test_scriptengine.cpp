@@ -0,0 +1,303 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for the script engine condition result cache.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <gtest/gtest.h>
+#include <namekeygenerator.h>
+#include <script.h>
+#include <scriptaction.h>
+#include <scriptcondition.h>
+#include <scriptconditions.h>
+#include <scriptengine.h>
+
+namespace
+{
+// Stands in for ScriptConditions, counting evaluations and answering whatever the test sets.
+class FakeScriptConditions : public ScriptConditionsInterface
+{
+public:
+    FakeScriptConditions() : m_result(false), m_evaluations(0) {}
+    virtual void Init() override {}
+    virtual void Reset() override {}
+    virtual void Update() override {}
+
+    virtual bool Evaluate_Condition(Condition *condition) override
+    {
+        m_evaluations++;
+        return m_result;
+    }
+
+    virtual bool Evaluate_Skirmish_Command_Button_Is_Ready(
+        Parameter *param1, Parameter *param2, Parameter *param3, bool b) override
+    {
+        return false;
+    }
+
+    virtual bool Evaluate_Team_Is_Contained(Parameter *param, bool b) override { return false; }
+
+    bool m_result;
+    int m_evaluations;
+};
+
+class ScriptEngineTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp() override
+    {
+        g_theNameKeyGenerator = new NameKeyGenerator;
+        g_theNameKeyGenerator->Init();
+        g_theScriptConditions = &m_conditions;
+        g_theScriptEngine = new ScriptEngine;
+        g_theScriptEngine->Init();
+    }
+
+    virtual void TearDown() override
+    {
+        delete g_theScriptEngine;
+        g_theScriptEngine = nullptr;
+        g_theScriptConditions = nullptr;
+        delete g_theNameKeyGenerator;
+        g_theNameKeyGenerator = nullptr;
+    }
+
+    // Runs a condition the way a script does, through Evaluate_Conditions with the given player as context.
+    bool Evaluate(Condition *condition, Player *player = nullptr)
+    {
+        Script *script = NEW_POOL_OBJ(Script);
+        OrCondition *or_condition = NEW_POOL_OBJ(OrCondition);
+        or_condition->Set_First_And_Condition(condition);
+        script->Set_Or_Condition(or_condition);
+        bool result = g_theScriptEngine->Evaluate_Conditions(script, nullptr, player);
+        or_condition->Set_First_And_Condition(nullptr);
+        script->Delete_Instance();
+        return result;
+    }
+
+    void Run_Action(ScriptAction::ScriptActionType type, const char *name, int value)
+    {
+        ScriptAction *action = NEW_POOL_OBJ(ScriptAction, type);
+
+        // Incrementing and decrementing take the amount first and the counter second.
+        if (type == ScriptAction::INCREMENT_COUNTER || type == ScriptAction::DECREMENT_COUNTER) {
+            action->Get_Parameter(0)->Set_Int(value);
+            action->Get_Parameter(1)->Set_String(name);
+        } else {
+            action->Get_Parameter(0)->Set_String(name);
+
+            if (action->Get_Num_Parameters() > 1) {
+                action->Get_Parameter(1)->Set_Int(value);
+            }
+        }
+
+        g_theScriptEngine->Execute_Actions(action);
+        action->Delete_Instance();
+    }
+
+    Condition *Make_Counter_Condition(const char *name, int comparison, int value)
+    {
+        Condition *condition = NEW_POOL_OBJ(Condition, Condition::COUNTER);
+        condition->Get_Parameter(0)->Set_String(name);
+        condition->Get_Parameter(1)->Set_Int(comparison);
+        condition->Get_Parameter(2)->Set_Int(value);
+        return condition;
+    }
+
+    Condition *Make_Flag_Condition(const char *name, bool value)
+    {
+        Condition *condition = NEW_POOL_OBJ(Condition, Condition::FLAG);
+        condition->Get_Parameter(0)->Set_String(name);
+        condition->Get_Parameter(1)->Set_Int(value);
+        return condition;
+    }
+
+    FakeScriptConditions m_conditions;
+};
+
+// Counter comparisons as stored in the parameter, see Parameter's comparison enum.
+const int COMPARE_GREATER_THAN_EQUAL = 3;
+} // namespace
+
+TEST_F(ScriptEngineTest, always_dirty_conditions_evaluate_every_time)
+{
+    // Player unit comparisons in trigger areas are left unclassified too.
+    const Condition::ConditionType types[] = { Condition::PLAYER_HAS_CREDITS,
+        Condition::PLAYER_HAS_COMPARISON_UNIT_TYPE_IN_TRIGGER_AREA,
+        Condition::PLAYER_HAS_COMPARISON_UNIT_KIND_IN_TRIGGER_AREA };
+
+    for (Condition::ConditionType type : types) {
+        Condition *condition = NEW_POOL_OBJ(Condition, type);
+        m_conditions.m_evaluations = 0;
+
+        for (int i = 0; i < 3; i++) {
+            Evaluate(condition);
+        }
+
+        EXPECT_EQ(m_conditions.m_evaluations, 3);
+        condition->Delete_Instance();
+    }
+}
+
+TEST_F(ScriptEngineTest, named_unit_conditions_wait_for_object_state_changes)
+{
+    Condition *condition = NEW_POOL_OBJ(Condition, Condition::NAMED_DESTROYED);
+    m_conditions.m_result = false;
+    EXPECT_FALSE(Evaluate(condition));
+    m_conditions.m_result = true;
+    EXPECT_FALSE(Evaluate(condition));
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+
+    // Unrelated inputs leave the result alone.
+    g_theScriptEngine->Notify_Of_Trigger_Area_Change();
+    Run_Action(ScriptAction::SET_COUNTER, "Unrelated", 5);
+    EXPECT_FALSE(Evaluate(condition));
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+
+    g_theScriptEngine->Notify_Of_Object_State_Change();
+    EXPECT_TRUE(Evaluate(condition));
+    EXPECT_EQ(m_conditions.m_evaluations, 2);
+    condition->Delete_Instance();
+}
+
+TEST_F(ScriptEngineTest, team_conditions_wait_for_object_state_changes)
+{
+    Condition *condition = NEW_POOL_OBJ(Condition, Condition::TEAM_HAS_UNITS);
+    m_conditions.m_result = true;
+    EXPECT_TRUE(Evaluate(condition));
+    m_conditions.m_result = false;
+    EXPECT_TRUE(Evaluate(condition));
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+
+    g_theScriptEngine->Notify_Of_Trigger_Area_Change();
+    EXPECT_TRUE(Evaluate(condition));
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+
+    g_theScriptEngine->Notify_Of_Object_State_Change();
+    EXPECT_FALSE(Evaluate(condition));
+    EXPECT_EQ(m_conditions.m_evaluations, 2);
+    condition->Delete_Instance();
+}
+
+TEST_F(ScriptEngineTest, context_change_reevaluates)
+{
+    // Parameters such as "<This Player>" resolve against the context, so the result only holds for the same one. The
+    // players are only compared, never looked at.
+    Player *player_a = reinterpret_cast<Player *>(0x1000);
+    Player *player_b = reinterpret_cast<Player *>(0x2000);
+    Condition *condition = NEW_POOL_OBJ(Condition, Condition::TEAM_HAS_UNITS);
+    Evaluate(condition, player_a);
+    Evaluate(condition, player_a);
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+    Evaluate(condition, player_b);
+    EXPECT_EQ(m_conditions.m_evaluations, 2);
+    Evaluate(condition, player_a);
+    EXPECT_EQ(m_conditions.m_evaluations, 3);
+    condition->Delete_Instance();
+}
+
+TEST_F(ScriptEngineTest, area_conditions_wait_for_area_and_object_changes)
+{
+    Condition *condition = NEW_POOL_OBJ(Condition, Condition::TEAM_INSIDE_AREA_PARTIALLY);
+    Evaluate(condition);
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+
+    Run_Action(ScriptAction::SET_FLAG, "Unrelated", 1);
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+
+    g_theScriptEngine->Notify_Of_Trigger_Area_Change();
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 2);
+
+    // Objects changing team or dying change which members count.
+    g_theScriptEngine->Notify_Of_Object_State_Change();
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 3);
+    condition->Delete_Instance();
+}
+
+TEST_F(ScriptEngineTest, counter_conditions_follow_their_counter)
+{
+    Condition *condition = Make_Counter_Condition("Waves", COMPARE_GREATER_THAN_EQUAL, 2);
+    EXPECT_FALSE(Evaluate(condition));
+    Run_Action(ScriptAction::SET_COUNTER, "Waves", 2);
+    EXPECT_TRUE(Evaluate(condition));
+    Run_Action(ScriptAction::DECREMENT_COUNTER, "Waves", 1);
+    EXPECT_FALSE(Evaluate(condition));
+    Run_Action(ScriptAction::INCREMENT_COUNTER, "Waves", 3);
+    EXPECT_TRUE(Evaluate(condition));
+
+    // Changing the counter behind the engine's back shows the result is kept, and dirtying another counter does not
+    // drop it.
+    const_cast<TCounter *>(g_theScriptEngine->Get_Counter("Waves"))->value = 0;
+    Run_Action(ScriptAction::SET_COUNTER, "Other", 7);
+    EXPECT_TRUE(Evaluate(condition));
+    Run_Action(ScriptAction::SET_COUNTER, "Waves", 0);
+    EXPECT_FALSE(Evaluate(condition));
+    condition->Delete_Instance();
+}
+
+TEST_F(ScriptEngineTest, flag_conditions_follow_their_flag_and_ui_hooks)
+{
+    Condition *condition = Make_Flag_Condition("Alarm", true);
+    EXPECT_FALSE(Evaluate(condition));
+    Run_Action(ScriptAction::SET_FLAG, "Other", 1);
+    EXPECT_FALSE(Evaluate(condition));
+    Run_Action(ScriptAction::SET_FLAG, "Alarm", 1);
+    EXPECT_TRUE(Evaluate(condition));
+    Run_Action(ScriptAction::SET_FLAG, "Alarm", 0);
+    EXPECT_FALSE(Evaluate(condition));
+
+    // A UI hook with the flag's name makes it true for the frame.
+    g_theScriptEngine->Signal_UI_Interact("Alarm");
+    EXPECT_TRUE(Evaluate(condition));
+    condition->Delete_Instance();
+}
+
+TEST_F(ScriptEngineTest, timer_conditions_follow_their_timer)
+{
+    Condition *condition = NEW_POOL_OBJ(Condition, Condition::TIMER_EXPIRED);
+    condition->Get_Parameter(0)->Set_String("Countdown");
+    EXPECT_FALSE(Evaluate(condition));
+
+    // A running timer at zero has expired, a stopped one never has.
+    Run_Action(ScriptAction::SET_TIMER, "Countdown", 0);
+    EXPECT_TRUE(Evaluate(condition));
+    Run_Action(ScriptAction::STOP_TIMER, "Countdown", 0);
+    EXPECT_FALSE(Evaluate(condition));
+    condition->Delete_Instance();
+}
+
+TEST_F(ScriptEngineTest, invalidate_and_modes)
+{
+    Condition *condition = NEW_POOL_OBJ(Condition, Condition::NAMED_DESTROYED);
+    Evaluate(condition);
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 1);
+
+    g_theScriptEngine->Invalidate_Condition_Cache();
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 2);
+
+    g_theScriptEngine->Set_Condition_Cache_Mode(ScriptEngine::CONDITION_CACHE_OFF);
+    Evaluate(condition);
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 4);
+
+    // Verification evaluates every time as well, but still keeps results for when the cache is turned back on.
+    g_theScriptEngine->Set_Condition_Cache_Mode(ScriptEngine::CONDITION_CACHE_VERIFY);
+    Evaluate(condition);
+    Evaluate(condition);
+    EXPECT_EQ(m_conditions.m_evaluations, 6);
+    condition->Delete_Instance();
+}
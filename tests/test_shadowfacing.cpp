@@ -0,0 +1,118 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for the batched shadow caster facing tests and the silhouette cache.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <w3dshadowfacing.h>
+
+namespace
+{
+// The test W3DVolumetricShadow::Build_Silhouette does one polygon at a time.
+bool Scalar_Is_Facing(const Vector3 &vertex, const Vector3 &normal, const Vector3 &light_pos)
+{
+    Vector3 v = vertex - light_pos;
+    return v * normal < 0.0f;
+}
+} // namespace
+
+TEST(shadowfacing, classify_matches_scalar)
+{
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+    const int counts[] = { 1, 3, 4, 31, 32, 33, 100, 1027 };
+
+    for (int count : counts) {
+        std::vector<Vector3> vertices(count);
+        std::vector<Vector3> normals(count);
+        ShadowFacingBatchClass batch;
+        batch.Init(count);
+
+        for (int i = 0; i < count; i++) {
+            vertices[i].Set(coord(rng), coord(rng), coord(rng));
+            normals[i].Set(coord(rng), coord(rng), coord(rng));
+
+            // Some polygons edge on to the light and some degenerate ones with no normal at all.
+            if (i % 7 == 0) {
+                normals[i].Set(0.0f, 0.0f, 0.0f);
+            } else {
+                normals[i].Normalize();
+            }
+
+            batch.Set_Polygon(i, vertices[i], normals[i]);
+        }
+
+        EXPECT_EQ(batch.Get_Count(), count);
+        ASSERT_EQ(batch.Get_Word_Count(), (count + 31) / 32);
+        std::vector<uint32_t> facing(batch.Get_Word_Count());
+
+        for (int trial = 0; trial < 50; trial++) {
+            Vector3 light_pos(coord(rng) * 10.0f, coord(rng) * 10.0f, coord(rng) * 10.0f);
+
+            if (trial == 0) {
+                light_pos = vertices[count / 2];
+            }
+
+            batch.Classify(light_pos, facing.data());
+
+            for (int i = 0; i < count; i++) {
+                EXPECT_EQ(ShadowFacingBatchClass::Is_Facing(facing.data(), i),
+                    Scalar_Is_Facing(vertices[i], normals[i], light_pos));
+            }
+
+            // Padding past the last polygon never faces the light.
+            for (int i = count; i < batch.Get_Word_Count() * 32; i++) {
+                EXPECT_FALSE(ShadowFacingBatchClass::Is_Facing(facing.data(), i));
+            }
+        }
+    }
+}
+
+TEST(shadowfacing, silhouette_cache)
+{
+    ShadowSilhouetteCacheClass cache;
+    uint32_t facing[2] = { 0x12345678, 0x9 };
+    const short indices[] = { 1, 2, 2, 3, 3, 1 };
+
+    EXPECT_EQ(cache.Find(facing, 2), nullptr);
+
+    cache.Add(facing, 2, indices, 6);
+    const std::vector<short> *found = cache.Find(facing, 2);
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(*found, std::vector<short>(indices, indices + 6));
+
+    // Any other set of facing bits misses, even with the same words otherwise.
+    uint32_t other[2] = { 0x12345678, 0x8 };
+    EXPECT_EQ(cache.Find(other, 2), nullptr);
+    EXPECT_EQ(cache.Find(facing, 1), nullptr);
+
+    // An empty silhouette is kept as well.
+    cache.Add(other, 2, indices, 0);
+    found = cache.Find(other, 2);
+    ASSERT_NE(found, nullptr);
+    EXPECT_TRUE(found->empty());
+
+    // Older sets make room for newer ones.
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t filler[2] = { i, 0xFFFFFFFF };
+        cache.Add(filler, 2, indices, 2);
+    }
+
+    EXPECT_EQ(cache.Find(facing, 2), nullptr);
+    uint32_t newest[2] = { 15, 0xFFFFFFFF };
+    EXPECT_NE(cache.Find(newest, 2), nullptr);
+
+    cache.Reset();
+    EXPECT_EQ(cache.Find(newest, 2), nullptr);
+}
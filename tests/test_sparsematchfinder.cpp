@@ -0,0 +1,293 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for resolving model condition flags to the best matching condition state.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <bitflags.h>
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <random>
+#include <sparsematchfinder.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+class ConditionStateClass
+{
+public:
+    ConditionStateClass(const char *definition) : m_definition(definition) {}
+
+    const ModelConditionBitFlags &Get_Conditions_Yes(int condition_idx) const { return m_conditions[condition_idx]; }
+    int Get_Conditions_Count() const { return m_conditions.size(); }
+    Utf8String Get_Definition() const { return m_definition; }
+
+    std::vector<ModelConditionBitFlags> m_conditions;
+    Utf8String m_definition;
+};
+
+ModelConditionBitFlags Parse_Conditions(const std::string &names)
+{
+    ModelConditionBitFlags flags;
+    std::istringstream stream(names);
+    std::string name;
+
+    while (stream >> name) {
+        EXPECT_TRUE(flags.Set_Bit_By_Name(name.c_str())) << name;
+    }
+
+    return flags;
+}
+
+// ConditionState and AliasConditionState blocks of a few Zero Hour objects. Each state lists its condition sets
+// separated by '|', an empty set being the DefaultConditionState.
+const char *const s_tankStates[] = {
+    "|SNOW|NIGHT|NIGHT SNOW",
+    "DAMAGED|DAMAGED SNOW|DAMAGED NIGHT|DAMAGED NIGHT SNOW",
+    "REALLYDAMAGED|REALLYDAMAGED SNOW|REALLYDAMAGED NIGHT|REALLYDAMAGED NIGHT SNOW",
+    "RUBBLE|RUBBLE SNOW|RUBBLE NIGHT|RUBBLE NIGHT SNOW",
+    "WEAPONSET_PLAYER_UPGRADE|WEAPONSET_PLAYER_UPGRADE SNOW|WEAPONSET_PLAYER_UPGRADE NIGHT",
+    "WEAPONSET_PLAYER_UPGRADE DAMAGED|WEAPONSET_PLAYER_UPGRADE DAMAGED SNOW|WEAPONSET_PLAYER_UPGRADE DAMAGED NIGHT",
+    "WEAPONSET_PLAYER_UPGRADE REALLYDAMAGED|WEAPONSET_PLAYER_UPGRADE REALLYDAMAGED SNOW",
+    "OVER_WATER|OVER_WATER DAMAGED",
+};
+
+const char *const s_infantryStates[] = {
+    "",
+    "MOVING|MOVING SNOW|MOVING NIGHT",
+    "ATTACKING|ATTACKING FIRING_A|FIRING_A|BETWEEN_FIRING_SHOTS_A",
+    "RELOADING_A|RELOADING_A MOVING",
+    "PRONE|PRONE MOVING",
+    "PANICKING|PANICKING MOVING",
+    "DYING|DYING MOVING",
+    "EXPLODED_FLAILING|EXPLODED_BOUNCING",
+    "SPLATTED",
+    "GARRISONED|GARRISONED FIRING_A",
+    "PARACHUTING|FREEFALL",
+    "RAPPELLING|CLIMBING",
+    "SPECIAL_CHEERING|RAISING_FLAG",
+    "STUNNED_FLAILING|STUNNED",
+    "USING_WEAPON_A|USING_WEAPON_A PREATTACK_A|USING_WEAPON_A FIRING_A",
+    "WEAPONSET_VETERAN ATTACKING|WEAPONSET_ELITE ATTACKING|WEAPONSET_HERO ATTACKING",
+};
+
+const char *const s_buildingStates[] = {
+    "|SNOW|NIGHT|NIGHT SNOW",
+    "DAMAGED|DAMAGED SNOW|DAMAGED NIGHT|DAMAGED NIGHT SNOW",
+    "REALLYDAMAGED|REALLYDAMAGED SNOW|REALLYDAMAGED NIGHT|REALLYDAMAGED NIGHT SNOW",
+    "RUBBLE|RUBBLE SNOW|RUBBLE NIGHT|RUBBLE NIGHT SNOW|POST_COLLAPSE",
+    "AWAITING_CONSTRUCTION|AWAITING_CONSTRUCTION SNOW|AWAITING_CONSTRUCTION NIGHT",
+    "PARTIALLY_CONSTRUCTED|PARTIALLY_CONSTRUCTED SNOW|PARTIALLY_CONSTRUCTED NIGHT",
+    "ACTIVELY_BEING_CONSTRUCTED|ACTIVELY_BEING_CONSTRUCTED NIGHT",
+    "POWER_PLANT_UPGRADING|POWER_PLANT_UPGRADED|POWER_PLANT_UPGRADED DAMAGED|POWER_PLANT_UPGRADED REALLYDAMAGED",
+    "RADAR_EXTENDING|RADAR_UPGRADED|RADAR_UPGRADED NIGHT",
+    "DOOR_1_OPENING|DOOR_1_WAITING_OPEN|DOOR_1_CLOSING|DOOR_1_WAITING_TO_CLOSE",
+    "DOOR_1_OPENING DAMAGED|DOOR_1_WAITING_OPEN DAMAGED|DOOR_1_CLOSING DAMAGED",
+    "DOOR_1_OPENING REALLYDAMAGED|DOOR_1_WAITING_OPEN REALLYDAMAGED|DOOR_1_CLOSING REALLYDAMAGED",
+    "ACTIVELY_CONSTRUCTING|CONSTRUCTION_COMPLETE",
+    "CAPTURED|CAPTURED DAMAGED|CAPTURED REALLYDAMAGED",
+    "SOLD",
+};
+
+std::vector<ConditionStateClass> Build_States(const char *const *states, int count)
+{
+    std::vector<ConditionStateClass> result;
+
+    for (int i = 0; i < count; ++i) {
+        result.push_back(ConditionStateClass(states[i]));
+        std::string sets = states[i];
+        size_t start = 0;
+
+        for (;;) {
+            size_t end = sets.find('|', start);
+            result.back().m_conditions.push_back(Parse_Conditions(sets.substr(start, end - start)));
+
+            if (end == std::string::npos) {
+                break;
+            }
+
+            start = end + 1;
+        }
+    }
+
+    return result;
+}
+
+// The search the finder has always done, counting the intersections of the flags directly.
+const ConditionStateClass *Reference_Best_Info(
+    const std::vector<ConditionStateClass> &states, const ModelConditionBitFlags &key)
+{
+    const ConditionStateClass *best_match = nullptr;
+    int best_match_count = 0;
+    int best_match_inv_count = 999;
+
+    for (const ConditionStateClass &state : states) {
+        for (int condition_idx = state.Get_Conditions_Count() - 1; condition_idx >= 0; condition_idx--) {
+            const ModelConditionBitFlags &conditions = state.Get_Conditions_Yes(condition_idx);
+            int intersection_count = key.Count_Intersection(conditions);
+            int inverse_intersection_count = key.Count_Inverse_Intersection(conditions);
+
+            if (intersection_count > best_match_count
+                || (intersection_count >= best_match_count && inverse_intersection_count < best_match_inv_count)) {
+                best_match = &state;
+                best_match_count = intersection_count;
+                best_match_inv_count = inverse_intersection_count;
+            }
+        }
+    }
+
+    return best_match;
+}
+
+// Flags the way a drawable ends up with them, mostly bits the states know about with some they ignore.
+std::vector<ModelConditionBitFlags> Random_Keys(
+    const std::vector<ConditionStateClass> &states, int count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<int> used;
+
+    for (const ConditionStateClass &state : states) {
+        for (const ModelConditionBitFlags &conditions : state.m_conditions) {
+            for (int bit = 0; bit < MODELCONDITION_COUNT; ++bit) {
+                if (conditions.Test(bit)) {
+                    used.push_back(bit);
+                }
+            }
+        }
+    }
+
+    std::vector<ModelConditionBitFlags> keys;
+
+    for (int i = 0; i < count; ++i) {
+        ModelConditionBitFlags key;
+        int bits = rng() % 5;
+
+        for (int j = 0; j < bits; ++j) {
+            key.Set(rng() % 4 != 0 ? used[rng() % used.size()] : int(rng() % MODELCONDITION_COUNT), true);
+        }
+
+        keys.push_back(key);
+    }
+
+    return keys;
+}
+} // namespace
+
+TEST(sparse_match_finder, matches_reference)
+{
+    const std::vector<ConditionStateClass> objects[] = {
+        Build_States(s_tankStates, ARRAY_SIZE(s_tankStates)),
+        Build_States(s_infantryStates, ARRAY_SIZE(s_infantryStates)),
+        Build_States(s_buildingStates, ARRAY_SIZE(s_buildingStates)),
+    };
+
+    for (const std::vector<ConditionStateClass> &states : objects) {
+        SparseMatchFinder<ConditionStateClass, ModelConditionBitFlags> finder;
+        std::vector<ModelConditionBitFlags> keys = Random_Keys(states, 2000, 11);
+
+        // Twice over so the second pass comes out of the cache.
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const ModelConditionBitFlags &key : keys) {
+                const ConditionStateClass *expected = Reference_Best_Info(states, key);
+
+                if (expected != nullptr) {
+                    ASSERT_EQ(expected, finder.Find_Best_Info(states, key));
+                }
+            }
+        }
+
+        // Every flag set by itself, including the ones on the highest word.
+        for (int bit = 0; bit < MODELCONDITION_COUNT; ++bit) {
+            ModelConditionBitFlags key(ModelConditionBitFlags::kInit, bit);
+            const ConditionStateClass *expected = Reference_Best_Info(states, key);
+
+            if (expected != nullptr) {
+                ASSERT_EQ(expected, finder.Find_Best_Info(states, key));
+            }
+        }
+
+        // A copy of the states has to be searched afresh rather than handing out the old entries.
+        std::vector<ConditionStateClass> copy = states;
+        ModelConditionBitFlags damaged(ModelConditionBitFlags::kInit, MODELCONDITION_DAMAGED);
+        const ConditionStateClass *match = finder.Find_Best_Info(copy, damaged);
+        EXPECT_EQ(Reference_Best_Info(copy, damaged), match);
+
+        finder.Clear();
+        EXPECT_EQ(Reference_Best_Info(states, damaged), finder.Find_Best_Info(states, damaged));
+    }
+}
+
+TEST(sparse_match_finder, DISABLED_timings)
+{
+    std::vector<ConditionStateClass> states = Build_States(s_infantryStates, ARRAY_SIZE(s_infantryStates));
+    std::vector<ConditionStateClass> buildings = Build_States(s_buildingStates, ARRAY_SIZE(s_buildingStates));
+    std::vector<ModelConditionBitFlags> keys = Random_Keys(states, 500, 12);
+    std::vector<ModelConditionBitFlags> building_keys = Random_Keys(buildings, 500, 13);
+    const int passes = 200;
+
+    // A battle's worth of drawables changing state, every key after the first pass was seen before.
+    auto begin = std::chrono::steady_clock::now();
+    int found = 0;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const ModelConditionBitFlags &key : keys) {
+            found += Reference_Best_Info(states, key) != nullptr;
+        }
+
+        for (const ModelConditionBitFlags &key : building_keys) {
+            found += Reference_Best_Info(buildings, key) != nullptr;
+        }
+    }
+
+    auto reference_end = std::chrono::steady_clock::now();
+    SparseMatchFinder<ConditionStateClass, ModelConditionBitFlags> finder;
+    SparseMatchFinder<ConditionStateClass, ModelConditionBitFlags> building_finder;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const ModelConditionBitFlags &key : keys) {
+            found -= finder.Find_Best_Info(states, key) != nullptr;
+        }
+
+        for (const ModelConditionBitFlags &key : building_keys) {
+            found -= building_finder.Find_Best_Info(buildings, key) != nullptr;
+        }
+    }
+
+    auto cached_end = std::chrono::steady_clock::now();
+
+    // Mostly flag combinations seen for the first time, so nearly every lookup has to search.
+    std::vector<ModelConditionBitFlags> fresh_keys = Random_Keys(buildings, 50000, 14);
+    SparseMatchFinder<ConditionStateClass, ModelConditionBitFlags> fresh_finder;
+
+    for (const ModelConditionBitFlags &key : fresh_keys) {
+        found += Reference_Best_Info(buildings, key) != nullptr;
+    }
+
+    auto fresh_reference_end = std::chrono::steady_clock::now();
+
+    for (const ModelConditionBitFlags &key : fresh_keys) {
+        found -= fresh_finder.Find_Best_Info(buildings, key) != nullptr;
+    }
+
+    auto fresh_end = std::chrono::steady_clock::now();
+    EXPECT_EQ(0, found);
+
+    printf("%d repeated lookups: searching %.2fms, finder %.2fms. %d new lookups: searching %.2fms, finder %.2fms\n",
+        passes * int(keys.size() + building_keys.size()),
+        std::chrono::duration<double, std::milli>(reference_end - begin).count(),
+        std::chrono::duration<double, std::milli>(cached_end - reference_end).count(),
+        int(fresh_keys.size()),
+        std::chrono::duration<double, std::milli>(fresh_reference_end - cached_end).count(),
+        std::chrono::duration<double, std::milli>(fresh_end - fresh_reference_end).count());
+}
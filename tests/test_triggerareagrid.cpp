@@ -0,0 +1,185 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for the grid used to find the polygon triggers containing a point.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <gtest/gtest.h>
+#include <polygontrigger.h>
+#include <random>
+#include <triggerareagrid.h>
+#include <vector>
+
+namespace
+{
+PolygonTrigger *Make_Trigger(const std::vector<std::pair<int, int>> &points, PolygonTrigger *next)
+{
+    PolygonTrigger *trigger = NEW_POOL_OBJ(PolygonTrigger, (int)points.size());
+
+    for (const std::pair<int, int> &p : points) {
+        ICoord3D pt;
+        pt.x = p.first;
+        pt.y = p.second;
+        pt.z = 0;
+        trigger->Add_Point(pt);
+    }
+
+    trigger->Set_Next(next);
+    return trigger;
+}
+
+// What Object::Set_Trigger_Area_Flags_For_Change_In_Position found before the grid, every trigger in list order.
+std::vector<PolygonTrigger *> List_Lookup(PolygonTrigger *first, ICoord3D pt)
+{
+    std::vector<PolygonTrigger *> found;
+
+    for (PolygonTrigger *t = first; t != nullptr; t = t->Get_Next()) {
+        if (t->Point_In_Trigger(pt)) {
+            found.push_back(t);
+        }
+    }
+
+    return found;
+}
+
+std::vector<PolygonTrigger *> Grid_Lookup(const TriggerAreaGrid &grid, ICoord3D pt)
+{
+    std::vector<PolygonTrigger *> found;
+    int count;
+    const TriggerAreaGrid::CellEntry *entries = grid.Get_Cell_Entries(pt, count);
+
+    for (int i = 0; i < count; i++) {
+        if (!entries[i].edge || entries[i].trigger->Point_In_Trigger(pt)) {
+            found.push_back(entries[i].trigger);
+        }
+    }
+
+    return found;
+}
+
+PolygonTrigger *Make_Map_Triggers()
+{
+    std::mt19937 rng(2718);
+    std::uniform_int_distribution<int> coord(-200, 1200);
+    PolygonTrigger *first = nullptr;
+
+    for (int i = 0; i < 12; i++) {
+        std::vector<std::pair<int, int>> points;
+        int count = 3 + i % 5;
+
+        for (int j = 0; j < count; j++) {
+            points.push_back(std::make_pair(coord(rng), coord(rng)));
+        }
+
+        first = Make_Trigger(points, first);
+    }
+
+    // Overlapping rectangles, a concave area, a thin sliver and a line with no interior.
+    first = Make_Trigger({ { 0, 0 }, { 400, 0 }, { 400, 300 }, { 0, 300 } }, first);
+    first = Make_Trigger({ { 100, 100 }, { 500, 100 }, { 500, 500 }, { 100, 500 } }, first);
+    first = Make_Trigger({ { 600, 600 }, { 900, 600 }, { 900, 700 }, { 700, 700 }, { 700, 900 }, { 600, 900 } }, first);
+    first = Make_Trigger({ { 10, 700 }, { 800, 703 }, { 10, 704 } }, first);
+    first = Make_Trigger({ { 300, 300 }, { 350, 380 } }, first);
+    return first;
+}
+} // namespace
+
+TEST(triggerareagrid, matches_list_walk)
+{
+    PolygonTrigger *first = Make_Map_Triggers();
+    std::mt19937 rng(31415);
+    std::uniform_int_distribution<int> coord(-300, 1300);
+    const int cell_sizes[] = { 1, 7, 40, 1000, 100000 };
+
+    for (int cell_size : cell_sizes) {
+        TriggerAreaGrid grid;
+        EXPECT_FALSE(grid.Is_Built());
+        grid.Build(first, cell_size);
+        EXPECT_TRUE(grid.Is_Built());
+
+        for (int i = 0; i < 20000; i++) {
+            ICoord3D pt;
+            pt.x = coord(rng);
+            pt.y = coord(rng);
+            pt.z = 0;
+            EXPECT_EQ(Grid_Lookup(grid, pt), List_Lookup(first, pt));
+        }
+
+        // The points and edges themselves are where the rounding in Point_In_Trigger matters most.
+        for (PolygonTrigger *t = first; t != nullptr; t = t->Get_Next()) {
+            for (int j = 0; j < t->Get_Num_Points(); j++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        ICoord3D pt = *t->Get_Point(j);
+                        pt.x += dx;
+                        pt.y += dy;
+                        EXPECT_EQ(Grid_Lookup(grid, pt), List_Lookup(first, pt));
+                    }
+                }
+            }
+        }
+    }
+
+    first->Delete_Instance();
+}
+
+TEST(triggerareagrid, interior_cells_skip_exact_test)
+{
+    PolygonTrigger *first = Make_Trigger({ { 0, 0 }, { 1000, 0 }, { 1000, 1000 }, { 0, 1000 } }, nullptr);
+    TriggerAreaGrid grid;
+    grid.Build(first, 50);
+
+    ICoord3D middle;
+    middle.x = 520;
+    middle.y = 480;
+    middle.z = 0;
+    int count;
+    const TriggerAreaGrid::CellEntry *entries = grid.Get_Cell_Entries(middle, count);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(entries[0].trigger, first);
+    EXPECT_FALSE(entries[0].edge);
+
+    ICoord3D corner;
+    corner.x = 5;
+    corner.y = 5;
+    corner.z = 0;
+    entries = grid.Get_Cell_Entries(corner, count);
+    ASSERT_EQ(count, 1);
+    EXPECT_TRUE(entries[0].edge);
+
+    // Outside the area covered by any trigger there is nothing to look at.
+    ICoord3D outside;
+    outside.x = -10;
+    outside.y = 2000;
+    outside.z = 0;
+    EXPECT_EQ(grid.Get_Cell_Entries(outside, count), nullptr);
+    EXPECT_EQ(count, 0);
+
+    grid.Reset();
+    EXPECT_FALSE(grid.Is_Built());
+    EXPECT_EQ(grid.Get_Cell_Entries(middle, count), nullptr);
+    first->Delete_Instance();
+}
+
+TEST(triggerareagrid, empty_list)
+{
+    TriggerAreaGrid grid;
+    grid.Build(nullptr, 10);
+    EXPECT_TRUE(grid.Is_Built());
+
+    ICoord3D pt;
+    pt.x = 0;
+    pt.y = 0;
+    pt.z = 0;
+    int count;
+    EXPECT_EQ(grid.Get_Cell_Entries(pt, count), nullptr);
+    EXPECT_EQ(count, 0);
+}
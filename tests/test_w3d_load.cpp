@@ -20,8 +20,18 @@
 #include "assetmgr.h"
 #include "bufffile.h"
 #include "chunkio.h"
+#include "hanim.h"
+#include "htree.h"
 #include "meshmdl.h"
+#include "motchan.h"
+#include "quat.h"
+#include "rawfile.h"
 #include "w3d_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <new>
+#include <random>
 
 struct Chunk
 {
@@ -115,3 +125,683 @@ TEST(w3d_model, load_model)
 
     cload.Close_Chunk();
 }
+
+namespace
+{
+// A copy of the adaptive delta decoder as it was before keyframes, frame cache and all, which the channel has to match
+// bit for bit. Its quirks are kept on purpose: the done flag is shared by the components so all but the first stop at
+// the end of the first block they decode, and a long forward seek carries on from the second cached frame as if it
+// were the first so it adds one delta twice.
+class AdaptiveDeltaReference
+{
+public:
+    AdaptiveDeltaReference(const std::vector<uint8_t> &data, int vector_len, unsigned frames, float scale) :
+        m_data(data), m_vectorLen(vector_len), m_numFrames(frames), m_scale(scale), m_cacheFrame(0x7FFFFFFF)
+    {
+        static const float powers[16] = { 1.0e-08f,
+            1.0e-07f,
+            1.0e-06f,
+            1.0e-05f,
+            0.0001f,
+            0.001f,
+            0.01f,
+            0.1f,
+            1.0f,
+            10.0f,
+            100.0f,
+            1000.0f,
+            10000.0f,
+            100000.0f,
+            1000000.0f,
+            10000000.0f };
+
+        for (int i = 0; i < 16; ++i) {
+            m_filter[i] = powers[i];
+        }
+
+        for (int i = 0; i < 240; ++i) {
+            m_filter[i + 16] = 1.0f - GameMath::Sin((i / 240.0f) * DEG_TO_RAD(90.0));
+        }
+
+        m_cacheData.resize(2 * m_vectorLen);
+    }
+
+    float Get_Frame(unsigned frame_idx, int vector_idx)
+    {
+        float dst[4];
+
+        if (frame_idx >= m_numFrames) {
+            frame_idx = m_numFrames - 1;
+        }
+
+        if (m_cacheFrame == frame_idx) {
+            return m_cacheData[vector_idx];
+        } else if (m_cacheFrame + 1 == frame_idx) {
+            return m_cacheData[m_vectorLen + vector_idx];
+        } else if (frame_idx < m_cacheFrame) {
+            Decompress(frame_idx, m_cacheData.data());
+
+            if (frame_idx != m_numFrames - 1) {
+                Decompress(frame_idx, m_cacheData.data(), frame_idx + 1, &m_cacheData[m_vectorLen]);
+            }
+
+            m_cacheFrame = frame_idx;
+            return m_cacheData[vector_idx];
+        } else if (frame_idx == m_cacheFrame + 2) {
+            memcpy(m_cacheData.data(), &m_cacheData[m_vectorLen], 4 * m_vectorLen);
+            Decompress(++m_cacheFrame, m_cacheData.data(), frame_idx, &m_cacheData[m_vectorLen]);
+            return m_cacheData[vector_idx + m_vectorLen];
+        } else {
+            memcpy(dst, &m_cacheData[m_vectorLen], 4 * m_vectorLen);
+            Decompress(m_cacheFrame, dst, frame_idx, m_cacheData.data());
+            m_cacheFrame = frame_idx;
+
+            if (frame_idx != m_numFrames - 1) {
+                Decompress(m_cacheFrame, m_cacheData.data(), frame_idx + 1, &m_cacheData[m_vectorLen]);
+            }
+
+            return m_cacheData[vector_idx];
+        }
+    }
+
+private:
+    float Delta(const uint8_t *packet, unsigned nibble) const
+    {
+        int delta = (packet[1 + nibble / 2] >> (4 * (nibble & 1))) & 0xF;
+        delta = delta >= 8 ? delta - 16 : delta;
+        float scale = m_filter[(signed char)packet[0]] * m_scale;
+        return (float)((double)delta * scale);
+    }
+
+    const uint8_t *Packet(unsigned block, int vector_idx) const
+    {
+        return &m_data[4 * m_vectorLen + 9 * (block * m_vectorLen + vector_idx)];
+    }
+
+    void Decompress(unsigned src_idx, const float *srcdata, unsigned frame_idx, float *outdata) const
+    {
+        bool done = false;
+
+        for (int i = 0; i < m_vectorLen; ++i) {
+            float value = srcdata[i];
+
+            for (unsigned step = src_idx + 1; step <= frame_idx; ++step) {
+                value = value + Delta(Packet((step - 1) / 16, i), (step - 1) % 16);
+
+                if (step == frame_idx) {
+                    done = true;
+                    break;
+                }
+
+                if (done && step % 16 == 0) {
+                    break;
+                }
+            }
+
+            outdata[i] = value;
+        }
+    }
+
+    void Decompress(unsigned frame_idx, float *outdata) const
+    {
+        float base[4];
+        memcpy(base, m_data.data(), 4 * m_vectorLen);
+        Decompress(0, base, frame_idx, outdata);
+    }
+
+    const std::vector<uint8_t> &m_data;
+    int m_vectorLen;
+    unsigned m_numFrames;
+    float m_scale;
+    float m_filter[256];
+    unsigned m_cacheFrame;
+    std::vector<float> m_cacheData;
+};
+
+std::vector<uint8_t> Make_Adaptive_Delta_Data(int vector_len, unsigned frames, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> base(-1.0f, 1.0f);
+    unsigned blocks = (frames + 14) / 16;
+    std::vector<uint8_t> data(4 * vector_len + 9 * blocks * vector_len);
+
+    for (int i = 0; i < vector_len; ++i) {
+        float value = base(rng);
+        memcpy(&data[4 * i], &value, sizeof(value));
+    }
+
+    for (size_t i = 4 * vector_len; i < data.size(); ++i) {
+        data[i] = (uint8_t)rng();
+    }
+
+    // The filter byte is read as a signed char, so from 128 up it indexes before the table. What lies there is no part
+    // of the decoder, so keep the filters inside the table.
+    for (size_t i = 4 * vector_len; i < data.size(); i += 9) {
+        data[i] &= 0x7F;
+    }
+
+    return data;
+}
+
+bool Load_Adaptive_Delta_Channel(
+    AdaptiveDeltaMotionChannelClass &channel, const std::vector<uint8_t> &data, int vector_len, unsigned frames, float scale)
+{
+    std::string filepath = testing::TempDir() + "adaptive_delta.w3d";
+
+    {
+        RawFileClass file(filepath.c_str());
+
+        if (!file.Open(FM_WRITE)) {
+            return false;
+        }
+
+        W3dAdaptiveDeltaAnimChannelStruct chan;
+        chan.NumFrames = frames;
+        chan.Pivot = 1;
+        chan.VectorLen = vector_len;
+        chan.Flags = vector_len == 4 ? ANIM_CHANNEL_Q : ANIM_CHANNEL_X;
+        chan.Scale = scale;
+        memcpy(chan.Data, data.data(), sizeof(chan.Data));
+
+        ChunkSaveClass csave(&file);
+        csave.Begin_Chunk(W3D_CHUNK_COMPRESSED_ANIMATION_CHANNEL);
+        csave.Write(&chan, sizeof(chan));
+        csave.Write(&data[sizeof(chan.Data)], data.size() - sizeof(chan.Data));
+        csave.End_Chunk();
+    }
+
+    BufferedFileClass file(filepath.c_str());
+
+    if (!file.Open(FM_READ)) {
+        return false;
+    }
+
+    ChunkLoadClass cload(&file);
+
+    if (!cload.Open_Chunk()) {
+        return false;
+    }
+
+    bool loaded = channel.Load_W3D(cload);
+    cload.Close_Chunk();
+    return loaded;
+}
+} // namespace
+
+TEST(w3d_anim, adaptive_delta_seeks)
+{
+    const unsigned frames = 301;
+    const float scale = 0.05f;
+
+    for (int vector_len : { 1, 4 }) {
+        std::vector<uint8_t> data = Make_Adaptive_Delta_Data(vector_len, frames, vector_len);
+        AdaptiveDeltaReference reference(data, vector_len, frames, scale);
+        AdaptiveDeltaMotionChannelClass channel;
+        ASSERT_TRUE(Load_Adaptive_Delta_Channel(channel, data, vector_len, frames, scale));
+
+        // Playback, a backwards jump, short and long skips and random seeks all have to give the bits they always did.
+        std::vector<unsigned> order;
+
+        for (unsigned frame = 0; frame < frames; ++frame) {
+            order.push_back(frame);
+        }
+
+        order.insert(order.end(), { 5, 4, 6, 8, 40, 41, 43, 15, 16, 17, 31, 33, 280, 300, 299, 301, 0 });
+        std::mt19937 rng(9);
+
+        for (int i = 0; i < 500; ++i) {
+            order.push_back(rng() % frames);
+        }
+
+        for (unsigned frame : order) {
+            for (int i = 0; i < vector_len; ++i) {
+                ASSERT_EQ(reference.Get_Frame(frame, i), channel.Get_Frame(frame, i))
+                    << "frame " << frame << " component " << i;
+            }
+        }
+    }
+}
+
+TEST(w3d_anim, DISABLED_adaptive_delta_random_frame_timings)
+{
+    const unsigned frames = 900;
+    const float scale = 0.05f;
+    const int units = 500;
+    const int samples = 20;
+    std::vector<uint8_t> data = Make_Adaptive_Delta_Data(4, frames, 17);
+    AdaptiveDeltaReference reference(data, 4, frames, scale);
+    AdaptiveDeltaMotionChannelClass channel;
+    ASSERT_TRUE(Load_Adaptive_Delta_Channel(channel, data, 4, frames, scale));
+
+    // Units sharing one animation each ask for the frame they are at, so the channel sees effectively random frames.
+    std::mt19937 rng(23);
+    std::vector<unsigned> lookups(units * samples);
+
+    for (unsigned &frame : lookups) {
+        frame = rng() % frames;
+    }
+
+    // A backwards lookup used to add up every delta of the first component from the first frame.
+    auto from_start_begin = std::chrono::steady_clock::now();
+    float from_start_sum = 0.0f;
+
+    for (unsigned frame : lookups) {
+        for (int i = 0; i < 4; ++i) {
+            from_start_sum += reference.Get_Frame(frame, i);
+        }
+    }
+
+    auto from_start_end = std::chrono::steady_clock::now();
+    float keyframe_sum = 0.0f;
+
+    for (unsigned frame : lookups) {
+        for (int i = 0; i < 4; ++i) {
+            keyframe_sum += channel.Get_Frame(frame, i);
+        }
+    }
+
+    auto keyframe_end = std::chrono::steady_clock::now();
+    EXPECT_EQ(from_start_sum, keyframe_sum);
+
+    printf("%d units, %d random frames each of %u: without keyframes %.2fms, with keyframes %.2fms\n",
+        units,
+        samples,
+        frames,
+        std::chrono::duration<double, std::milli>(from_start_end - from_start_begin).count(),
+        std::chrono::duration<double, std::milli>(keyframe_end - from_start_end).count());
+}
+
+namespace
+{
+// Animation whose channels are smooth functions of the pivot and frame, standing in for a loaded one.
+class ProceduralAnimClass : public HAnimClass
+{
+public:
+    ProceduralAnimClass(int num_pivots, float phase) : m_numPivots(num_pivots), m_phase(phase) {}
+
+    virtual const char *Get_Name() const override { return "PROCEDURAL"; }
+    virtual const char *Get_HName() const override { return "SKELETON"; }
+    virtual int Get_Num_Frames() override { return 120; }
+    virtual float Get_Frame_Rate() override { return 30.0f; }
+    virtual float Get_Total_Time() override { return 4.0f; }
+
+    virtual void Get_Translation(Vector3 &trans, int pividx, float frame) const override
+    {
+        float t = frame * 0.05f + pividx * 0.3f + m_phase;
+        trans.Set(0.1f * GameMath::Sin(t), 0.05f * GameMath::Cos(t * 1.3f), 0.02f * GameMath::Sin(t * 0.7f));
+    }
+
+    virtual void Get_Orientation(Quaternion &q, int pividx, float frame) const override
+    {
+        float t = frame * 0.04f + pividx * 0.5f + m_phase;
+        Vector3 axis(GameMath::Sin(pividx * 1.1f), GameMath::Cos(pividx * 0.9f), 0.5f);
+        axis.Normalize();
+        float s = GameMath::Sin(t * 0.5f);
+        q.Set(axis.X * s, axis.Y * s, axis.Z * s, GameMath::Cos(t * 0.5f));
+    }
+
+    virtual void Get_Transform(Matrix3D &mtx, int pividx, float frame) const override
+    {
+        Vector3 trans;
+        Quaternion q;
+        Get_Translation(trans, pividx, frame);
+        Get_Orientation(q, pividx, frame);
+        mtx = Build_Matrix3D(q);
+        mtx.Set_Translation(trans);
+    }
+
+    virtual bool Get_Visibility(int pividx, float frame) override { return (pividx + (int)frame) % 7 != 0; }
+    virtual int Get_Num_Pivots() const override { return m_numPivots; }
+    virtual bool Is_Node_Motion_Present(int pividx) override { return true; }
+
+private:
+    int m_numPivots;
+    float m_phase;
+};
+
+std::vector<W3dPivotStruct> Make_Skeleton_Pivots(int num_pivots, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+    std::vector<W3dPivotStruct> pivots(num_pivots);
+
+    for (int i = 0; i < num_pivots; ++i) {
+        W3dPivotStruct &pivot = pivots[i];
+        memset(&pivot, 0, sizeof(pivot));
+        snprintf(pivot.Name, sizeof(pivot.Name), "BONE%02d", i);
+        pivot.ParentIdx = i == 0 ? 0xFFFFFFFF : rng() % i;
+        pivot.Translation.x = offset(rng);
+        pivot.Translation.y = offset(rng);
+        pivot.Translation.z = offset(rng);
+
+        Quaternion q(offset(rng), offset(rng), offset(rng), 1.0f);
+        q.Normalize();
+        pivot.Rotation.q[0] = q.X;
+        pivot.Rotation.q[1] = q.Y;
+        pivot.Rotation.q[2] = q.Z;
+        pivot.Rotation.q[3] = q.W;
+    }
+
+    return pivots;
+}
+
+bool Load_Skeleton(HTreeClass &htree, const std::vector<W3dPivotStruct> &pivots)
+{
+    std::string filepath = testing::TempDir() + "skeleton.w3d";
+
+    {
+        RawFileClass file(filepath.c_str());
+
+        if (!file.Open(FM_WRITE)) {
+            return false;
+        }
+
+        W3dHierarchyStruct header;
+        memset(&header, 0, sizeof(header));
+        header.Version = 0x40001;
+        strcpy(header.Name, "SKELETON");
+        header.NumPivots = pivots.size();
+
+        ChunkSaveClass csave(&file);
+        csave.Begin_Chunk(W3D_CHUNK_HIERARCHY);
+        csave.Begin_Chunk(W3D_CHUNK_HIERARCHY_HEADER);
+        csave.Write(&header, sizeof(header));
+        csave.End_Chunk();
+        csave.Begin_Chunk(W3D_CHUNK_PIVOTS);
+        csave.Write(pivots.data(), pivots.size() * sizeof(W3dPivotStruct));
+        csave.End_Chunk();
+        csave.End_Chunk();
+    }
+
+    BufferedFileClass file(filepath.c_str());
+
+    if (!file.Open(FM_READ)) {
+        return false;
+    }
+
+    ChunkLoadClass cload(&file);
+
+    if (!cload.Open_Chunk()) {
+        return false;
+    }
+
+    bool loaded = htree.Load_W3D(cload) == 0;
+    cload.Close_Chunk();
+    return loaded;
+}
+
+// Skeleton evaluated one pivot at a time straight from the pivot data, the way the tree used to do it.
+class SkeletonReference
+{
+public:
+    SkeletonReference(const std::vector<W3dPivotStruct> &pivots) :
+        m_parent(pivots.size()), m_base(pivots.size()), m_transform(pivots.size()), m_visible(pivots.size(), true)
+    {
+        for (size_t i = 0; i < pivots.size(); ++i) {
+            const W3dPivotStruct &pivot = pivots[i];
+            m_parent[i] = (int)pivot.ParentIdx;
+            m_base[i].Make_Identity();
+            m_base[i].Translate(Vector3(pivot.Translation.x, pivot.Translation.y, pivot.Translation.z));
+            Quaternion q(pivot.Rotation.q[0], pivot.Rotation.q[1], pivot.Rotation.q[2], pivot.Rotation.q[3]);
+            m_base[i].Post_Mul(Build_Matrix3D(q));
+        }
+    }
+
+    void Anim_Update(const Matrix3D &root, HAnimClass *motion, float frame)
+    {
+        m_transform[0] = root;
+        m_visible[0] = true;
+
+        for (size_t i = 1; i < m_base.size(); ++i) {
+            Matrix3D::Multiply(m_transform[m_parent[i]], m_base[i], &m_transform[i]);
+
+            if ((int)i < motion->Get_Num_Pivots()) {
+                Vector3 trans;
+                motion->Get_Translation(trans, i, frame);
+                m_transform[i].Translate(trans);
+                Quaternion q;
+                motion->Get_Orientation(q, i, frame);
+                m_transform[i].Post_Mul(Build_Matrix3D(q));
+                m_visible[i] = motion->Get_Visibility(i, frame);
+            }
+        }
+    }
+
+    void Blend_Update(
+        const Matrix3D &root, HAnimClass *motion0, float frame0, HAnimClass *motion1, float frame1, float percentage)
+    {
+        m_transform[0] = root;
+        m_visible[0] = true;
+        int num_anim_pivots = std::min(motion0->Get_Num_Pivots(), motion1->Get_Num_Pivots());
+
+        for (size_t i = 1; i < m_base.size(); ++i) {
+            Matrix3D::Multiply(m_transform[m_parent[i]], m_base[i], &m_transform[i]);
+
+            if ((int)i < num_anim_pivots) {
+                Vector3 translation0, translation1, translation;
+                motion0->Get_Translation(translation0, i, frame0);
+                motion1->Get_Translation(translation1, i, frame1);
+                Vector3::Lerp(translation0, translation1, percentage, &translation);
+                m_transform[i].Translate(translation);
+                Quaternion rotation0, rotation1, rotation;
+                motion0->Get_Orientation(rotation0, i, frame0);
+                motion1->Get_Orientation(rotation1, i, frame1);
+                Fast_Slerp(rotation, rotation0, rotation1, percentage);
+                m_transform[i].Post_Mul(Build_Matrix3D(rotation));
+                m_visible[i] = motion0->Get_Visibility(i, frame0) || motion1->Get_Visibility(i, frame1);
+            }
+        }
+    }
+
+    const Matrix3D &Get_Transform(int pivot) const { return m_transform[pivot]; }
+    bool Get_Visibility(int pivot) const { return m_visible[pivot]; }
+
+private:
+    std::vector<int> m_parent;
+    std::vector<Matrix3D> m_base;
+    std::vector<Matrix3D> m_transform;
+    std::vector<bool> m_visible;
+};
+
+void Expect_Same_Pose(HTreeClass &htree, const SkeletonReference &reference)
+{
+    for (int i = 0; i < htree.Num_Pivots(); ++i) {
+        const Matrix3D &tm = htree.Get_Transform(i);
+        const Matrix3D &expected = reference.Get_Transform(i);
+
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                EXPECT_NEAR(expected[row][col], tm[row][col], 1.0e-5f) << "pivot " << i;
+            }
+        }
+
+        EXPECT_EQ(reference.Get_Visibility(i), htree.Get_Visibility(i)) << "pivot " << i;
+    }
+}
+} // namespace
+
+TEST(w3d_anim, htree_batched_update)
+{
+    std::vector<W3dPivotStruct> pivots = Make_Skeleton_Pivots(45, 3);
+    HTreeClass htree;
+    ASSERT_TRUE(Load_Skeleton(htree, pivots));
+    ASSERT_EQ(45, htree.Num_Pivots());
+    SkeletonReference reference(pivots);
+
+    // One animation covering every pivot and one covering only some of them, as happens with mismatched skeletons.
+    ProceduralAnimClass full(45, 0.0f);
+    ProceduralAnimClass partial(30, 1.5f);
+    Matrix3D root(true);
+    root.Rotate_Z(0.3f);
+    root.Set_Translation(Vector3(10.0f, -4.0f, 2.0f));
+
+    for (float frame = 0.0f; frame < 60.0f; frame += 3.5f) {
+        htree.Anim_Update(root, &full, frame);
+        reference.Anim_Update(root, &full, frame);
+        Expect_Same_Pose(htree, reference);
+
+        htree.Anim_Update(root, &partial, frame);
+        reference.Anim_Update(root, &partial, frame);
+        Expect_Same_Pose(htree, reference);
+
+        htree.Blend_Update(root, &full, frame, &partial, frame * 0.5f, 0.35f);
+        reference.Blend_Update(root, &full, frame, &partial, frame * 0.5f, 0.35f);
+        Expect_Same_Pose(htree, reference);
+    }
+}
+
+TEST(w3d_anim, DISABLED_htree_update_timings)
+{
+    const int num_pivots = 60;
+    const int trees = 200;
+    const int frames = 50;
+    std::vector<W3dPivotStruct> pivots = Make_Skeleton_Pivots(num_pivots, 11);
+    std::vector<HTreeClass> htrees(trees);
+    std::vector<SkeletonReference> references(trees, SkeletonReference(pivots));
+    ProceduralAnimClass anim(num_pivots, 0.25f);
+    Matrix3D root(true);
+
+    for (HTreeClass &htree : htrees) {
+        ASSERT_TRUE(Load_Skeleton(htree, pivots));
+    }
+
+    // Every visible unit updates its skeleton each frame, all of them playing the same animation.
+    auto per_pivot_begin = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; ++frame) {
+        for (SkeletonReference &reference : references) {
+            reference.Anim_Update(root, &anim, (float)frame);
+        }
+    }
+
+    auto per_pivot_end = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; ++frame) {
+        for (HTreeClass &htree : htrees) {
+            htree.Anim_Update(root, &anim, (float)frame);
+        }
+    }
+
+    auto batched_end = std::chrono::steady_clock::now();
+    Expect_Same_Pose(htrees.back(), references.back());
+
+    printf("%d skeletons of %d pivots over %d frames: per pivot %.2fms, batched %.2fms\n",
+        trees,
+        num_pivots,
+        frames,
+        std::chrono::duration<double, std::milli>(per_pivot_end - per_pivot_begin).count(),
+        std::chrono::duration<double, std::milli>(batched_end - per_pivot_end).count());
+}
+
+namespace
+{
+void Expect_Identical_Pose(HTreeClass &htree, HTreeClass &expected)
+{
+    for (int i = 0; i < htree.Num_Pivots(); ++i) {
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                EXPECT_EQ(expected.Get_Transform(i)[row][col], htree.Get_Transform(i)[row][col]) << "pivot " << i;
+            }
+        }
+
+        EXPECT_EQ(expected.Get_Visibility(i), htree.Get_Visibility(i)) << "pivot " << i;
+    }
+}
+} // namespace
+
+TEST(w3d_anim, htree_pose_cache)
+{
+    const int num_pivots = 40;
+    std::vector<W3dPivotStruct> pivots = Make_Skeleton_Pivots(num_pivots, 7);
+    std::vector<HTreeClass> cached(4);
+    std::vector<HTreeClass> uncached(4);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(Load_Skeleton(cached[i], pivots));
+        ASSERT_TRUE(Load_Skeleton(uncached[i], pivots));
+    }
+
+    // One unit has a turret bone under script control, which is applied after the shared pose.
+    Matrix3D turret(true);
+    turret.Rotate_Z(0.8f);
+    cached[2].Capture_Bone(12);
+    cached[2].Control_Bone(12, turret, false);
+    uncached[2].Capture_Bone(12);
+    uncached[2].Control_Bone(12, turret, false);
+
+    ProceduralAnimClass walk(num_pivots, 0.0f);
+    ProceduralAnimClass fire(30, 2.0f);
+
+    for (float frame = 0.0f; frame < 40.0f; frame += 0.5f) {
+        for (int i = 0; i < 4; ++i) {
+            Matrix3D root(true);
+            root.Rotate_Z(i * 0.7f);
+            root.Set_Translation(Vector3(i * 20.0f, 5.0f, 0.0f));
+
+            HTreeClass::Set_Pose_Caching(false);
+            uncached[i].Anim_Update(root, &walk, frame);
+            HTreeClass::Set_Pose_Caching(true);
+            cached[i].Anim_Update(root, &walk, frame);
+            Expect_Identical_Pose(cached[i], uncached[i]);
+
+            HTreeClass::Set_Pose_Caching(false);
+            uncached[i].Blend_Update(root, &walk, frame, &fire, frame * 2.0f, 0.25f);
+            HTreeClass::Set_Pose_Caching(true);
+            cached[i].Blend_Update(root, &walk, frame, &fire, frame * 2.0f, 0.25f);
+            Expect_Identical_Pose(cached[i], uncached[i]);
+        }
+    }
+
+    // A new animation created where a freed one lived must not be handed the old poses.
+    alignas(ProceduralAnimClass) unsigned char storage[sizeof(ProceduralAnimClass)];
+    SkeletonReference reference(pivots);
+    Matrix3D root(true);
+
+    for (int i = 0; i < 3; ++i) {
+        ProceduralAnimClass *anim = new (storage) ProceduralAnimClass(num_pivots, i * 1.3f);
+        cached[0].Anim_Update(root, anim, 10.0f);
+        reference.Anim_Update(root, anim, 10.0f);
+        Expect_Same_Pose(cached[0], reference);
+        anim->~ProceduralAnimClass();
+    }
+}
+
+TEST(w3d_anim, DISABLED_htree_pose_cache_timings)
+{
+    const int num_pivots = 60;
+    const int trees = 200;
+    const int frames = 50;
+    std::vector<W3dPivotStruct> pivots = Make_Skeleton_Pivots(num_pivots, 11);
+    std::vector<HTreeClass> htrees(trees);
+    ProceduralAnimClass march(num_pivots, 0.25f);
+    ProceduralAnimClass idle(num_pivots, 1.0f);
+
+    for (HTreeClass &htree : htrees) {
+        ASSERT_TRUE(Load_Skeleton(htree, pivots));
+    }
+
+    // A blob of identical units, most marching in step and the rest on a shared idle loop.
+    double ms[2];
+
+    for (int caching = 0; caching < 2; ++caching) {
+        HTreeClass::Set_Pose_Caching(caching != 0);
+        auto begin = std::chrono::steady_clock::now();
+
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int i = 0; i < trees; ++i) {
+                Matrix3D root(true);
+                root.Set_Translation(Vector3((float)i, 0.0f, 0.0f));
+                htrees[i].Anim_Update(root, (i % 4) == 0 ? &idle : &march, (float)frame);
+            }
+        }
+
+        ms[caching] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    printf("%d skeletons of %d pivots over %d frames: sampled per instance %.2fms, pose cache %.2fms\n",
+        trees,
+        num_pivots,
+        frames,
+        ms[0],
+        ms[1]);
+}
@@ -12,10 +12,23 @@
  *            A full copy of the GNU General Public License can be found in
  *            LICENSE
  */
+#include <algorithm>
+#include <chrono>
+#include <colmath.h>
+#include <cstdio>
+#include <cstring>
+#include <depthsort.h>
+#include <dynaabtreecull.h>
+#include <frustum.h>
+#include <frustumcull.h>
 #include <gtest/gtest.h>
+#include <list>
+#include <obbox.h>
+#include <random>
 #include <vector2.h>
 #include <vector3.h>
 #include <vector4.h>
+#include <vp.h>
 
 #include <vector2i.h>
 #include <vector3i.h>
@@ -181,3 +194,625 @@ TEST(w3d_math, matrix4)
     Matrix4 inv = mat.Inverse();
     EXPECT_FLOAT_EQ(inv[0][0], 0.5f);
 }
+
+TEST(w3d_math, depth_sort_matches_comparator)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> depth(-500.0f, 500.0f);
+    DepthSortClass sorter;
+
+    for (unsigned count : { 0u, 1u, 5u, 32u, 33u, 1000u, 20000u }) {
+        std::vector<float> depths(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            // Plenty of repeated depths and both zeros to check equal keys keep their order.
+            switch (i % 7) {
+                case 0:
+                    depths[i] = (float)(int)(depth(rng) / 50.0f);
+                    break;
+                case 1:
+                    depths[i] = (i & 8) != 0 ? -0.0f : 0.0f;
+                    break;
+                default:
+                    depths[i] = depth(rng);
+                    break;
+            }
+        }
+
+        std::vector<uint32_t> expected(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            expected[i] = i;
+        }
+
+        std::stable_sort(expected.begin(), expected.end(), [&depths](uint32_t a, uint32_t b) {
+            return depths[a] < depths[b];
+        });
+
+        uint32_t *keys = sorter.Get_Key_Array(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            keys[i] = DepthSortClass::Ascending_Key(depths[i]);
+        }
+
+        const uint32_t *order = sorter.Sort(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            ASSERT_EQ(expected[i], order[i]);
+        }
+
+        std::stable_sort(expected.begin(), expected.end(), [&depths](uint32_t a, uint32_t b) {
+            return depths[a] > depths[b];
+        });
+
+        keys = sorter.Get_Key_Array(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            keys[i] = DepthSortClass::Descending_Key(depths[i]);
+        }
+
+        order = sorter.Sort(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            ASSERT_EQ(expected[i], order[i]);
+        }
+    }
+}
+
+TEST(w3d_math, DISABLED_depth_sort_timings)
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> depth(1.0f, 2000.0f);
+    DepthSortClass sorter;
+
+    for (unsigned count : { 500u, 2000u, 8000u }) {
+        std::vector<float> depths(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            depths[i] = depth(rng);
+        }
+
+        // The ordered list inserts the sorting renderer used to do for every node.
+        auto insert_begin = std::chrono::steady_clock::now();
+        std::list<float> list;
+
+        for (float z : depths) {
+            std::list<float>::iterator it = list.begin();
+
+            while (it != list.end() && !(z > *it)) {
+                ++it;
+            }
+
+            list.insert(it, z);
+        }
+
+        auto insert_end = std::chrono::steady_clock::now();
+        std::vector<float> sorted(depths);
+        std::sort(sorted.begin(), sorted.end());
+        auto sort_end = std::chrono::steady_clock::now();
+        uint32_t *keys = sorter.Get_Key_Array(count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            keys[i] = DepthSortClass::Descending_Key(depths[i]);
+        }
+
+        const uint32_t *order = sorter.Sort(count);
+        auto radix_end = std::chrono::steady_clock::now();
+
+        unsigned i = 0;
+
+        for (float z : list) {
+            EXPECT_EQ(z, depths[order[i++]]);
+        }
+
+        printf("%u nodes: ordered inserts %.3fms, comparison sort %.3fms, radix sort %.3fms\n",
+            count,
+            std::chrono::duration<double, std::milli>(insert_end - insert_begin).count(),
+            std::chrono::duration<double, std::milli>(sort_end - insert_end).count(),
+            std::chrono::duration<double, std::milli>(radix_end - sort_end).count());
+    }
+}
+
+TEST(w3d_math, frustum_cull_batch)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coord(-400.0f, 400.0f);
+    std::uniform_real_distribution<float> radius(0.0f, 40.0f);
+    FrustumCullBatchClass batch;
+
+    for (int view = 0; view < 8; ++view) {
+        Matrix3D camera(true);
+        camera.Look_At(Vector3(coord(rng), coord(rng), 200.0f), Vector3(coord(rng), coord(rng), 0.0f), 0.0f);
+        FrustumClass frustum;
+        frustum.Init(camera, Vector2(-0.6f, -0.45f), Vector2(0.6f, 0.45f), 1.0f, 800.0f);
+
+        std::vector<SphereClass> spheres;
+        batch.Reset();
+
+        // Odd counts leave a partly filled last batch.
+        for (int i = 0; i < 4001 + view; ++i) {
+            SphereClass sphere(Vector3(coord(rng), coord(rng), coord(rng) * 0.25f), radius(rng));
+            spheres.push_back(sphere);
+            EXPECT_EQ(i, batch.Add_Sphere(sphere));
+        }
+
+        const uint8_t *culled = batch.Cull(frustum);
+        int outside = 0;
+
+        for (size_t i = 0; i < spheres.size(); ++i) {
+            bool expected = CollisionMath::Overlap_Test(frustum, spheres[i]) == CollisionMath::OUTSIDE;
+            ASSERT_EQ(expected, culled[i] != 0);
+            outside += expected;
+        }
+
+        // Both outcomes have to show up for the comparison to mean anything.
+        EXPECT_GT(outside, 0);
+        EXPECT_LT(outside, (int)spheres.size());
+    }
+}
+
+namespace
+{
+struct VectorProcessorResults
+{
+    std::vector<Vector3> transform;
+    std::vector<Vector3> transform_no_w;
+    std::vector<Vector4> transform_4;
+    std::vector<unsigned> copy_indexed;
+    std::vector<float> copy_indexed_float;
+    std::vector<Vector4> clamp;
+    std::vector<Vector3> normalize;
+    Vector3 min;
+    Vector3 max;
+    std::vector<float> mul_add;
+    std::vector<float> dot_product;
+    std::vector<float> clamp_min;
+};
+
+struct VectorProcessorInputs
+{
+    VectorProcessorInputs(int count, unsigned seed) :
+        vectors(count), colors(count), values(count), bits(count), index(count), transform(true), projection(true)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+
+        for (int i = 0; i < count; ++i) {
+            // Some zero vectors so Normalize has to leave them alone.
+            vectors[i] = i % 5 == 3 ? Vector3(0.0f, 0.0f, 0.0f) : Vector3(value(rng), value(rng), value(rng));
+            colors[i] = Vector4(value(rng), value(rng), value(rng), value(rng)) * 0.02f;
+            values[i] = value(rng);
+            bits[i] = rng();
+            index[i] = rng() % count;
+        }
+
+        transform.Rotate_X(0.3f);
+        transform.Rotate_Z(1.1f);
+        transform.Set_Translation(Vector3(5.0f, -3.0f, 12.0f));
+        projection.Init_Perspective(DEG_TO_RADF(60.0f), 1.3f, 0.5f, 1000.0f);
+        projection = projection * Matrix4(transform);
+    }
+
+    std::vector<Vector3> vectors;
+    std::vector<Vector4> colors;
+    std::vector<float> values;
+    std::vector<unsigned> bits;
+    std::vector<unsigned> index;
+    Matrix3D transform;
+    Matrix4 projection;
+};
+
+VectorProcessorResults Run_Vector_Processor(const VectorProcessorInputs &in, int count)
+{
+    VectorProcessorResults out;
+    out.transform.resize(count);
+    out.transform_no_w.resize(count);
+    out.transform_4.resize(count);
+    out.copy_indexed.resize(count);
+    out.copy_indexed_float.resize(count);
+    out.clamp.resize(count);
+    out.normalize.assign(in.vectors.begin(), in.vectors.begin() + count);
+    out.mul_add.assign(in.values.begin(), in.values.begin() + count);
+    out.dot_product.resize(count);
+    out.clamp_min.resize(count);
+    std::vector<float> values(in.values);
+
+    VectorProcessorClass::Transform(out.transform.data(), in.vectors.data(), in.transform, count);
+    VectorProcessorClass::TransformNoW(out.transform_no_w.data(), in.vectors.data(), in.transform, count);
+    VectorProcessorClass::Transform(out.transform_4.data(), in.vectors.data(), in.projection, count);
+    VectorProcessorClass::CopyIndexed(out.copy_indexed.data(), in.bits.data(), in.index.data(), count);
+    VectorProcessorClass::CopyIndexed(out.copy_indexed_float.data(), values.data(), in.index.data(), count);
+    VectorProcessorClass::Clamp(out.clamp.data(), in.colors.data(), 0.0f, 1.0f, count);
+    VectorProcessorClass::Normalize(out.normalize.data(), count);
+    out.min.Set(0.0f, 0.0f, 0.0f);
+    out.max.Set(0.0f, 0.0f, 0.0f);
+    VectorProcessorClass::MinMax(const_cast<Vector3 *>(in.vectors.data()), out.min, out.max, count);
+    VectorProcessorClass::MulAdd(out.mul_add.data(), 0.37f, -2.5f, count);
+    VectorProcessorClass::DotProduct(out.dot_product.data(), Vector3(0.2f, -0.7f, 0.4f), in.vectors.data(), count);
+    VectorProcessorClass::ClampMin(out.clamp_min.data(), values.data(), 1.5f, count);
+    return out;
+}
+
+// 32 bit x86 builds without SSE2 maths compile the scalar functions to x87 code, which can round differently from the
+// SIMD paths in the last bit or so. Elsewhere every instruction set has to give the scalar bits exactly.
+#if (defined(_M_IX86) && (!defined(_M_IX86_FP) || _M_IX86_FP < 2)) || (defined(__i386__) && !defined(__SSE2_MATH__))
+const int SCALAR_MAX_ULPS = 4;
+#else
+const int SCALAR_MAX_ULPS = 0;
+#endif
+
+int64_t Ordered_Bits(float value)
+{
+    int32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits < 0 ? int64_t(INT32_MIN) - bits : bits;
+}
+
+bool Matches_Scalar(const float *a, const float *b, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        int64_t ulps = Ordered_Bits(a[i]) - Ordered_Bits(b[i]);
+
+        if (ulps > SCALAR_MAX_ULPS || ulps < -SCALAR_MAX_ULPS) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename T> bool Matches_Scalar(const std::vector<T> &a, const std::vector<T> &b)
+{
+    static_assert(sizeof(T) % sizeof(float) == 0, "Only float vectors are compared by value");
+    return a.size() == b.size()
+        && Matches_Scalar(reinterpret_cast<const float *>(a.data()),
+            reinterpret_cast<const float *>(b.data()),
+            a.size() * sizeof(T) / sizeof(float));
+}
+
+bool Matches_Scalar(const std::vector<unsigned> &a, const std::vector<unsigned> &b)
+{
+    return a == b;
+}
+
+bool Matches_Scalar(const Vector3 &a, const Vector3 &b)
+{
+    return Matches_Scalar(&a.X, &b.X, 3);
+}
+} // namespace
+
+TEST(w3d_math, vector_processor_matches_scalar)
+{
+    VectorProcessorClass::InstructionSetType previous = VectorProcessorClass::Get_Instruction_Set();
+    VectorProcessorInputs in(67, 21);
+
+    // Counts around the four and eight wide batches so both the wide loops and the scalar tails get used.
+    for (int count : { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 67 }) {
+        ASSERT_TRUE(VectorProcessorClass::Set_Instruction_Set(VectorProcessorClass::INSTRUCTIONS_SCALAR));
+        VectorProcessorResults expected = Run_Vector_Processor(in, count);
+
+        for (int type = VectorProcessorClass::INSTRUCTIONS_SCALAR + 1; type < VectorProcessorClass::INSTRUCTIONS_COUNT;
+             ++type) {
+            if (!VectorProcessorClass::Set_Instruction_Set(VectorProcessorClass::InstructionSetType(type))) {
+                continue;
+            }
+
+            VectorProcessorResults result = Run_Vector_Processor(in, count);
+            EXPECT_TRUE(Matches_Scalar(expected.transform, result.transform)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.transform_no_w, result.transform_no_w)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.transform_4, result.transform_4)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.copy_indexed, result.copy_indexed)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.copy_indexed_float, result.copy_indexed_float))
+                << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.clamp, result.clamp)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.normalize, result.normalize)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.min, result.min)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.max, result.max)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.mul_add, result.mul_add)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.dot_product, result.dot_product)) << "set " << type << " count " << count;
+            EXPECT_TRUE(Matches_Scalar(expected.clamp_min, result.clamp_min)) << "set " << type << " count " << count;
+        }
+    }
+
+    VectorProcessorClass::Set_Instruction_Set(previous);
+}
+
+TEST(w3d_math, DISABLED_vector_processor_timings)
+{
+    static const char *const names[VectorProcessorClass::INSTRUCTIONS_COUNT] = { "scalar", "SSE2", "AVX2", "NEON" };
+    const int count = 20000;
+    const int passes = 50;
+    VectorProcessorClass::InstructionSetType previous = VectorProcessorClass::Get_Instruction_Set();
+    VectorProcessorInputs in(count, 8);
+    std::vector<Vector3> vectors(count);
+    std::vector<Vector4> vectors4(count);
+    std::vector<float> floats(count);
+
+    // Roughly the per frame work of a few hundred skinned or deformed meshes.
+    for (int type = VectorProcessorClass::INSTRUCTIONS_SCALAR; type < VectorProcessorClass::INSTRUCTIONS_COUNT; ++type) {
+        if (!VectorProcessorClass::Set_Instruction_Set(VectorProcessorClass::InstructionSetType(type))) {
+            continue;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+
+        for (int pass = 0; pass < passes; ++pass) {
+            VectorProcessorClass::Transform(vectors.data(), in.vectors.data(), in.transform, count);
+        }
+
+        auto transform_end = std::chrono::steady_clock::now();
+
+        for (int pass = 0; pass < passes; ++pass) {
+            VectorProcessorClass::Transform(vectors4.data(), in.vectors.data(), in.projection, count);
+        }
+
+        auto project_end = std::chrono::steady_clock::now();
+
+        for (int pass = 0; pass < passes; ++pass) {
+            vectors = in.vectors;
+            VectorProcessorClass::Normalize(vectors.data(), count);
+        }
+
+        auto normalize_end = std::chrono::steady_clock::now();
+
+        for (int pass = 0; pass < passes; ++pass) {
+            VectorProcessorClass::CopyIndexed(floats.data(), const_cast<float *>(in.values.data()), in.index.data(), count);
+        }
+
+        auto copy_end = std::chrono::steady_clock::now();
+
+        printf("%s, %d passes over %d vectors: transform %.2fms, project %.2fms, normalize %.2fms, indexed copy %.2fms\n",
+            names[type],
+            passes,
+            count,
+            std::chrono::duration<double, std::milli>(transform_end - begin).count(),
+            std::chrono::duration<double, std::milli>(project_end - transform_end).count(),
+            std::chrono::duration<double, std::milli>(normalize_end - project_end).count(),
+            std::chrono::duration<double, std::milli>(copy_end - normalize_end).count());
+    }
+
+    VectorProcessorClass::Set_Instruction_Set(previous);
+}
+
+namespace
+{
+class TestCullableClass : public CullableClass
+{
+public:
+    TestCullableClass(int id) : m_id(id) {}
+
+    int m_id;
+};
+
+typedef TypedDynamicAABTreeCullSystemClass<TestCullableClass> TestCullSystemClass;
+
+AABoxClass Random_Cull_Box(std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(0.25f, 8.0f);
+    return AABoxClass(
+        Vector3(coord(rng), coord(rng), coord(rng) * 0.1f), Vector3(size(rng), size(rng), size(rng)));
+}
+
+std::vector<int> Take_Collected(TestCullSystemClass &system)
+{
+    std::vector<int> ids;
+
+    for (TestCullableClass *obj = system.Get_First_Collected_Object(); obj != nullptr;
+         obj = system.Get_Next_Collected_Object(obj)) {
+        ids.push_back(obj->m_id);
+    }
+
+    system.Reset_Collection();
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+template<typename TestType> std::vector<int> Brute_Force(const std::vector<TestCullableClass *> &objs, TestType test)
+{
+    std::vector<int> ids;
+
+    for (TestCullableClass *obj : objs) {
+        if (obj != nullptr && test(obj->Get_Cull_Box())) {
+            ids.push_back(obj->m_id);
+        }
+    }
+
+    return ids;
+}
+
+FrustumClass Random_Frustum(std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    Matrix3D camera(true);
+    camera.Look_At(Vector3(coord(rng), coord(rng), 150.0f), Vector3(coord(rng), coord(rng), 0.0f), 0.0f);
+    FrustumClass frustum;
+    frustum.Init(camera, Vector2(-0.5f, -0.4f), Vector2(0.5f, 0.4f), 1.0f, 400.0f);
+    return frustum;
+}
+
+void Check_Cull_Queries(TestCullSystemClass &system, const std::vector<TestCullableClass *> &objs, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(1.0f, 60.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+    int hits = 0;
+
+    for (int i = 0; i < 16; ++i) {
+        FrustumClass frustum = Random_Frustum(rng);
+        system.Collect_Objects(frustum);
+        std::vector<int> expected = Brute_Force(objs, [&](const AABoxClass &box) {
+            return CollisionMath::Overlap_Test(frustum, box) != CollisionMath::OUTSIDE;
+        });
+        ASSERT_EQ(expected, Take_Collected(system));
+        hits += (int)expected.size();
+
+        AABoxClass aabox(Vector3(coord(rng), coord(rng), 0.0f), Vector3(size(rng), size(rng), size(rng)));
+        system.Collect_Objects(aabox);
+        expected = Brute_Force(
+            objs, [&](const AABoxClass &box) { return CollisionMath::Intersection_Test(aabox, box); });
+        ASSERT_EQ(expected, Take_Collected(system));
+        hits += (int)expected.size();
+
+        Matrix3D rotation(true);
+        rotation.Rotate_Z(angle(rng));
+        rotation.Rotate_X(angle(rng));
+        OBBoxClass obbox(
+            Vector3(coord(rng), coord(rng), 0.0f), Vector3(size(rng), size(rng), size(rng)), Matrix3(rotation));
+        system.Collect_Objects(obbox);
+        expected = Brute_Force(
+            objs, [&](const AABoxClass &box) { return CollisionMath::Intersection_Test(obbox, box); });
+        ASSERT_EQ(expected, Take_Collected(system));
+        hits += (int)expected.size();
+
+        SphereClass sphere(Vector3(coord(rng), coord(rng), 0.0f), size(rng));
+        system.Collect_Objects(sphere);
+        expected = Brute_Force(
+            objs, [&](const AABoxClass &box) { return CollisionMath::Intersection_Test(sphere, box); });
+        ASSERT_EQ(expected, Take_Collected(system));
+        hits += (int)expected.size();
+
+        // Aim the point at an object so it hits something.
+        Vector3 point = objs[i * 4]->Get_Cull_Box().m_center;
+        system.Collect_Objects(point);
+        expected = Brute_Force(objs, [&](const AABoxClass &box) {
+            return CollisionMath::Overlap_Test(box, point) != CollisionMath::POS;
+        });
+        ASSERT_EQ(expected, Take_Collected(system));
+        EXPECT_FALSE(expected.empty());
+    }
+
+    EXPECT_GT(hits, 0);
+}
+} // namespace
+
+TEST(w3d_math, dynamic_aabtree_cull_matches_brute_force)
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> jump(-100.0f, 100.0f);
+    std::vector<TestCullableClass *> objs;
+    TestCullSystemClass system;
+
+    for (int i = 0; i < 5000; ++i) {
+        TestCullableClass *obj = new TestCullableClass(i);
+        obj->Set_Cull_Box(Random_Cull_Box(rng));
+        system.Add_Object(obj);
+        objs.push_back(obj);
+    }
+
+    EXPECT_EQ(5000, system.Get_Object_Count());
+    EXPECT_TRUE(system.Validate());
+    EXPECT_LT(system.Get_Height(), 30);
+    Check_Cull_Queries(system, objs, rng);
+
+    // Small moves stay within the grown leaf boxes, big ones have to move leaves around the tree.
+    for (int i = 0; i < 5000; i += 2) {
+        AABoxClass box = objs[i]->Get_Cull_Box();
+        float step = i % 4 == 0 ? jitter(rng) : jump(rng);
+        box.m_center += Vector3(step, -step, step * 0.1f);
+        objs[i]->Set_Cull_Box(box);
+    }
+
+    EXPECT_TRUE(system.Validate());
+    Check_Cull_Queries(system, objs, rng);
+
+    for (int i = 1; i < 5000; i += 4) {
+        system.Remove_Object(objs[i]);
+        EXPECT_EQ(nullptr, objs[i]->Get_Culling_System());
+        objs[i]->Release_Ref();
+        objs[i] = nullptr;
+    }
+
+    EXPECT_EQ(3750, system.Get_Object_Count());
+    EXPECT_TRUE(system.Validate());
+    Check_Cull_Queries(system, objs, rng);
+
+    system.Remove_All();
+    EXPECT_EQ(0, system.Get_Object_Count());
+    EXPECT_TRUE(system.Validate());
+
+    for (TestCullableClass *obj : objs) {
+        if (obj != nullptr) {
+            EXPECT_EQ(nullptr, obj->Get_Cull_Link());
+            obj->Release_Ref();
+        }
+    }
+}
+
+TEST(w3d_math, DISABLED_dynamic_aabtree_cull_timings)
+{
+    const int count = 50000;
+    const int views = 200;
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> jitter(-2.0f, 2.0f);
+    std::vector<TestCullableClass *> objs;
+    std::vector<FrustumClass> frustums;
+    TestCullSystemClass system;
+
+    for (int i = 0; i < count; ++i) {
+        TestCullableClass *obj = new TestCullableClass(i);
+        obj->Set_Cull_Box(Random_Cull_Box(rng));
+        objs.push_back(obj);
+    }
+
+    for (int i = 0; i < views; ++i) {
+        frustums.push_back(Random_Frustum(rng));
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+
+    for (TestCullableClass *obj : objs) {
+        system.Add_Object(obj);
+    }
+
+    auto build_end = std::chrono::steady_clock::now();
+    int tree_hits = 0;
+
+    for (const FrustumClass &frustum : frustums) {
+        system.Collect_Objects(frustum);
+        tree_hits += (int)Take_Collected(system).size();
+    }
+
+    auto tree_end = std::chrono::steady_clock::now();
+    int brute_hits = 0;
+
+    for (const FrustumClass &frustum : frustums) {
+        std::vector<int> ids;
+
+        for (TestCullableClass *obj : objs) {
+            if (CollisionMath::Overlap_Test(frustum, obj->Get_Cull_Box()) != CollisionMath::OUTSIDE) {
+                ids.push_back(obj->m_id);
+            }
+        }
+
+        brute_hits += (int)ids.size();
+    }
+
+    auto brute_end = std::chrono::steady_clock::now();
+
+    // Every object moves a little each frame, as units wandering around a map would.
+    for (int frame = 0; frame < 10; ++frame) {
+        for (TestCullableClass *obj : objs) {
+            AABoxClass box = obj->Get_Cull_Box();
+            box.m_center += Vector3(jitter(rng), jitter(rng), 0.0f);
+            obj->Set_Cull_Box(box);
+        }
+    }
+
+    auto update_end = std::chrono::steady_clock::now();
+    EXPECT_EQ(brute_hits, tree_hits);
+    EXPECT_TRUE(system.Validate());
+
+    printf("%d cullables: build %.2fms, %d frustums %.2fms against %.2fms testing every box, 10 frames of moves %.2fms\n",
+        count,
+        std::chrono::duration<double, std::milli>(build_end - begin).count(),
+        views,
+        std::chrono::duration<double, std::milli>(tree_end - build_end).count(),
+        std::chrono::duration<double, std::milli>(brute_end - tree_end).count(),
+        std::chrono::duration<double, std::milli>(update_end - brute_end).count());
+
+    for (TestCullableClass *obj : objs) {
+        obj->Release_Ref();
+    }
+}
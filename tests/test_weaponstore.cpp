@@ -0,0 +1,89 @@
+/**
+ * @file
+ *
+ * @author Thyme Developers
+ *
+ * @brief Tests for finding weapon templates in the weapon store.
+ *
+ * @copyright Thyme is free software: you can redistribute it and/or
+ *            modify it under the terms of the GNU General Public License
+ *            as published by the Free Software Foundation, either version
+ *            2 of the License, or (at your option) any later version.
+ *            A full copy of the GNU General Public License can be found in
+ *            LICENSE
+ */
+#include <gtest/gtest.h>
+#include <namekeygenerator.h>
+#include <string>
+#include <weapon.h>
+
+class WeaponStoreTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp() override
+    {
+        g_theNameKeyGenerator = new NameKeyGenerator;
+        g_theNameKeyGenerator->Init();
+        m_store = new WeaponStore();
+    }
+
+    virtual void TearDown() override
+    {
+        delete m_store;
+        delete g_theNameKeyGenerator;
+        g_theNameKeyGenerator = nullptr;
+    }
+
+    WeaponStore *m_store;
+};
+
+TEST_F(WeaponStoreTest, find_by_name)
+{
+    // Find_Weapon_Template asserts on names it does not know, so check for missing ones by key.
+    EXPECT_EQ(m_store->Find_Weapon_Template_Private(g_theNameKeyGenerator->Name_To_Key("Cannon")), nullptr);
+
+    WeaponTemplate *cannon = m_store->New_Weapon_Template("Cannon");
+    WeaponTemplate *rifle = m_store->New_Weapon_Template("Rifle");
+    ASSERT_NE(cannon, nullptr);
+    ASSERT_NE(rifle, nullptr);
+
+    EXPECT_EQ(m_store->Find_Weapon_Template("Cannon"), cannon);
+    EXPECT_EQ(m_store->Find_Weapon_Template("Rifle"), rifle);
+    EXPECT_EQ(m_store->Find_Weapon_Template_Private(cannon->Get_Name_Key()), cannon);
+    EXPECT_EQ(m_store->Find_Weapon_Template("None"), nullptr);
+    EXPECT_EQ(m_store->New_Weapon_Template(""), nullptr);
+
+    // Keys made for other things fall inside or past the indexed range without finding anything.
+    NameKeyType unrelated = g_theNameKeyGenerator->Name_To_Key("Unrelated");
+    EXPECT_EQ(m_store->Find_Weapon_Template_Private(unrelated), nullptr);
+    EXPECT_EQ(m_store->Find_Weapon_Template_Private(NameKeyType(unrelated + 1000)), nullptr);
+    EXPECT_EQ(m_store->Find_Weapon_Template_Private(NAMEKEY_INVALID), nullptr);
+    EXPECT_EQ(m_store->Find_Weapon_Template_Private(NameKeyType(-1)), nullptr);
+}
+
+TEST_F(WeaponStoreTest, first_template_with_name_wins)
+{
+    // Keys handed out before the templates are created leave gaps at the start of the index.
+    for (int i = 0; i < 100; i++) {
+        g_theNameKeyGenerator->Name_To_Key(("Padding" + std::to_string(i)).c_str());
+    }
+
+    WeaponTemplate *first = m_store->New_Weapon_Template("Laser");
+    WeaponTemplate *second = m_store->New_Weapon_Template("Laser");
+    ASSERT_NE(first, second);
+    EXPECT_EQ(m_store->Find_Weapon_Template("Laser"), first);
+}
+
+TEST_F(WeaponStoreTest, overrides_keep_original_in_index)
+{
+    WeaponTemplate *cannon = m_store->New_Weapon_Template("Cannon");
+    WeaponTemplate *copy = m_store->New_Override(cannon);
+    ASSERT_NE(copy, nullptr);
+    EXPECT_EQ(m_store->Find_Weapon_Template("Cannon"), cannon);
+
+    // Overrides are owned by whoever made them and never enter the index.
+    copy->Friend_Clear_Next_Template();
+    copy->Delete_Instance();
+    m_store->Reset();
+    EXPECT_EQ(m_store->Find_Weapon_Template("Cannon"), cannon);
+}